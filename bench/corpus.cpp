@@ -0,0 +1,197 @@
+#include "corpus.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace proga::bench {
+
+namespace {
+
+// Cumulative Zipf weights over `n` ranks; sampling is a binary search
+// on a uniform draw, so the hot head costs the same as the tail.
+std::vector<double> zipf_cdf(int n, double exponent) {
+  std::vector<double> cum(static_cast<size_t>(n));
+  double total = 0;
+  for (int i = 0; i < n; ++i) {
+    total += 1.0 / std::pow(static_cast<double>(i + 1), exponent);
+    cum[static_cast<size_t>(i)] = total;
+  }
+  for (double& c : cum) c /= total;
+  return cum;
+}
+
+int sample_zipf(const std::vector<double>& cdf, double u) {
+  size_t lo = 0;
+  size_t hi = cdf.size() - 1;
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if (cdf[mid] < u) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return static_cast<int>(lo);
+}
+
+}  // namespace
+
+bool parse_profile(const std::string& spec, CorpusOptions& options) {
+  size_t pos = 0;
+  while (pos < spec.size()) {
+    size_t comma = spec.find(',', pos);
+    if (comma == std::string::npos) comma = spec.size();
+    size_t eq = spec.find('=', pos);
+    if (eq == std::string::npos || eq >= comma) return false;
+    std::string key = spec.substr(pos, eq - pos);
+    std::string value = spec.substr(eq + 1, comma - eq - 1);
+    if (value.empty()) return false;
+    char* end = nullptr;
+    if (key == "records") {
+      options.records = strtoull(value.c_str(), &end, 10);
+    } else if (key == "seed") {
+      options.seed = strtoull(value.c_str(), &end, 10);
+    } else if (key == "url_cardinality") {
+      options.url_cardinality =
+          static_cast<int>(strtol(value.c_str(), &end, 10));
+    } else if (key == "max_pad") {
+      options.max_pad = static_cast<int>(strtol(value.c_str(), &end, 10));
+    } else if (key == "url_zipf") {
+      options.url_zipf = strtod(value.c_str(), &end);
+    } else if (key == "burstiness") {
+      options.burstiness = strtod(value.c_str(), &end);
+    } else if (key == "size_tail") {
+      options.size_tail = strtod(value.c_str(), &end);
+    } else if (key == "duplicate_rate") {
+      options.duplicate_rate = strtod(value.c_str(), &end);
+    } else if (key == "out_of_order") {
+      options.out_of_order = strtod(value.c_str(), &end);
+    } else {
+      return false;
+    }
+    if (end == nullptr || *end != '\0') return false;
+    pos = comma + 1;
+  }
+  return true;
+}
+
+bool write_corpus(const std::string& path, const CorpusOptions& options) {
+  std::FILE* f = fopen(path.c_str(), "w");
+  if (f == nullptr) return false;
+  static const char* kMethods[] = {"GET", "GET", "GET", "POST", "PUT",
+                                   "DELETE"};
+  static const int kStatuses[] = {200, 200, 200, 200, 301, 404, 500};
+  uint64_t rng = options.seed;
+
+  std::vector<double> url_cdf;
+  if (options.url_zipf > 0 && options.url_cardinality > 1) {
+    url_cdf = zipf_cdf(options.url_cardinality, options.url_zipf);
+  }
+  // Ring of recent lines backing exact duplicates.
+  constexpr size_t kRecent = 64;
+  std::vector<std::string> recent;
+  recent.reserve(kRecent);
+  size_t recent_next = 0;
+
+  // Records are formatted into a buffer and written in 1 MB chunks;
+  // per-record fprintf throttles generation well before the disk does.
+  std::string out;
+  out.reserve(1 << 20);
+  char line[4608];
+
+  uint64_t ts = 1700000000000ull;
+  uint64_t burst_left = 0;
+  bool ok = true;
+  for (uint64_t i = 0; i < options.records && ok; ++i) {
+    uint64_t r = splitmix64(rng);
+
+    size_t line_len;
+    if (options.duplicate_rate > 0 && !recent.empty() &&
+        unit_double(splitmix64(rng)) < options.duplicate_rate) {
+      const std::string& dup = recent[r % recent.size()];
+      line_len = dup.size() < sizeof(line) ? dup.size() : sizeof(line) - 1;
+      memcpy(line, dup.data(), line_len);
+    } else {
+      const char* method = kMethods[r % 6];
+      int status = kStatuses[(r >> 8) % 7];
+
+      int url;
+      if (!url_cdf.empty()) {
+        url = sample_zipf(url_cdf, unit_double(splitmix64(rng)));
+      } else {
+        url = static_cast<int>(
+            (r >> 16) % static_cast<uint64_t>(options.url_cardinality));
+      }
+
+      int latency = static_cast<int>((r >> 32) % 2000);
+
+      int pad = 0;
+      if (options.size_tail > 0) {
+        // Pareto: mostly small records, occasional multi-KB ones.
+        double v = unit_double(splitmix64(rng));
+        double len = 8.0 * std::pow(1.0 - v, -1.0 / options.size_tail);
+        pad = len > 4000 ? 4000 : static_cast<int>(len);
+      } else if (options.max_pad > 0) {
+        pad = static_cast<int>((r >> 48) %
+                               static_cast<uint64_t>(options.max_pad));
+      }
+
+      // Burst windows advance time by 0-1 ms; idle gaps by up to 2 s.
+      if (burst_left > 0) {
+        --burst_left;
+        ts += (r >> 24) % 2;
+      } else {
+        if (options.burstiness > 0 &&
+            unit_double(splitmix64(rng)) < options.burstiness / 16) {
+          burst_left = 8 + (r >> 40) % 16;  // ~16 records per burst
+        }
+        ts += 1 + (r >> 8) % 2000;
+      }
+      uint64_t emitted_ts = ts;
+      if (options.out_of_order > 0 &&
+          unit_double(splitmix64(rng)) < options.out_of_order) {
+        uint64_t lag = 1 + (r >> 16) % 60000;  // up to a minute late
+        emitted_ts = ts > lag ? ts - lag : 0;
+      }
+
+      int n = snprintf(line, sizeof(line),
+                       "{\"request_id\":\"req-%012llu\",\"ts\":%llu,"
+                       "\"method\":\"%s\",\"url\":\"/api/v1/resource/%d\","
+                       "\"status\":%d,\"latency_ms\":%d,\"pad\":\"%*d\"}",
+                       static_cast<unsigned long long>(i),
+                       static_cast<unsigned long long>(emitted_ts), method,
+                       url, status, latency, pad + 1, 0);
+      if (n <= 0 || static_cast<size_t>(n) >= sizeof(line)) {
+        ok = false;
+        break;
+      }
+      line_len = static_cast<size_t>(n);
+
+      if (options.duplicate_rate > 0) {
+        if (recent.size() < kRecent) {
+          recent.emplace_back(line, line_len);
+        } else {
+          recent[recent_next].assign(line, line_len);
+          recent_next = (recent_next + 1) % kRecent;
+        }
+      }
+    }
+
+    out.append(line, line_len);
+    out.push_back('\n');
+    if (out.size() >= (1 << 20)) {
+      ok = fwrite(out.data(), 1, out.size(), f) == out.size();
+      out.clear();
+    }
+  }
+  if (ok && !out.empty()) {
+    ok = fwrite(out.data(), 1, out.size(), f) == out.size();
+  }
+  if (fclose(f) != 0) ok = false;
+  return ok;
+}
+
+}  // namespace proga::bench
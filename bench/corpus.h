@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace proga::bench {
+
+// Shape knobs for a synthetic requests.jsonl corpus. The defaults
+// approximate production request logs: a few string fields with
+// repetition, numeric latency/status, and variable padding. The skew
+// knobs (all zero by default, which keeps the legacy flat shape)
+// reproduce the pathologies of real logs that uniform random data
+// hides: hot URLs, arrival bursts, long-tail record sizes, repeated
+// records and late-arriving timestamps.
+struct CorpusOptions {
+  uint64_t records = 100000;
+  uint64_t seed = 42;
+  int url_cardinality = 500;
+  int max_pad = 80;  // upper bound on per-record free-text padding
+
+  // Zipf exponent for URL ranks; ~1.0 matches typical web traffic
+  // (a handful of URLs take most hits). 0 keeps URLs uniform.
+  double url_zipf = 0;
+  // Approximate fraction of records emitted inside arrival bursts,
+  // where timestamps advance by 0-1 ms instead of the idle gap.
+  double burstiness = 0;
+  // Pareto tail exponent for padding length; smaller means heavier
+  // tail (occasional multi-KB records). 0 keeps the uniform pad.
+  double size_tail = 0;
+  // Fraction of records that byte-for-byte re-emit a recent line.
+  double duplicate_rate = 0;
+  // Fraction of records whose timestamp regresses behind the stream.
+  double out_of_order = 0;
+};
+
+// Fills `options` from a declarative profile string of the form
+// "records=1000000,url_zipf=1.1,burstiness=0.3". Unknown keys or
+// malformed entries fail the whole parse.
+bool parse_profile(const std::string& spec, CorpusOptions& options);
+
+// Writes a synthetic corpus to `path`. Returns false on I/O failure.
+bool write_corpus(const std::string& path, const CorpusOptions& options);
+
+// Deterministic 64-bit PRNG (splitmix64); shared by corpus shaping.
+inline uint64_t splitmix64(uint64_t& state) {
+  uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+// Uniform double in [0, 1) from one PRNG draw.
+inline double unit_double(uint64_t r) {
+  return static_cast<double>(r >> 11) * (1.0 / 9007199254740992.0);
+}
+
+}  // namespace proga::bench
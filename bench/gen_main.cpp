@@ -0,0 +1,45 @@
+// Standalone workload generator (`make gen` builds proga_gen).
+//
+// Synthesizes requests.jsonl-shaped logs from a declarative profile,
+// so benchmark inputs reproduce production skew — hot URLs, bursts,
+// long-tail sizes, duplicates, late timestamps — and repro workloads
+// can be shared as a one-line profile instead of customer data:
+//
+//   proga_gen --output skewed.jsonl --profile
+//     "records=1000000,url_zipf=1.1,size_tail=1.3,duplicate_rate=0.02"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "corpus.h"
+
+int main(int argc, char** argv) {
+  std::string output = "corpus.jsonl";
+  proga::bench::CorpusOptions options;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+      output = argv[++i];
+    } else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+      if (!proga::bench::parse_profile(argv[++i], options)) {
+        fprintf(stderr, "bad profile: %s\n", argv[i]);
+        return 2;
+      }
+    } else {
+      fprintf(stderr, "usage: %s [--output path] [--profile k=v,...]\n",
+              argv[0]);
+      fprintf(stderr,
+              "profile keys: records seed url_cardinality max_pad url_zipf "
+              "burstiness size_tail duplicate_rate out_of_order\n");
+      return 2;
+    }
+  }
+
+  fprintf(stderr, "generating %llu records -> %s\n",
+          static_cast<unsigned long long>(options.records), output.c_str());
+  if (!proga::bench::write_corpus(output, options)) {
+    fprintf(stderr, "failed to write %s\n", output.c_str());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,250 @@
+#include "harness.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace proga::bench {
+
+namespace {
+
+std::atomic<uint64_t> g_alloc_count{0};
+
+std::vector<std::pair<std::string, BenchFn>>& registry() {
+  static std::vector<std::pair<std::string, BenchFn>> benches;
+  return benches;
+}
+
+double percentile(std::vector<double> sorted, double p) {
+  if (sorted.empty()) return 0;
+  size_t idx = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+  return sorted[std::min(idx, sorted.size() - 1)];
+}
+
+}  // namespace
+
+uint64_t alloc_count() {
+  return g_alloc_count.load(std::memory_order_relaxed);
+}
+
+Registrar::Registrar(const char* name, BenchFn fn) {
+  registry().emplace_back(name, std::move(fn));
+}
+
+bool run_all(const Options& options) {
+  using Clock = std::chrono::steady_clock;
+  std::vector<Result> results;
+  for (auto& [name, fn] : registry()) {
+    State state;
+    for (int i = 0; i < options.warmup_reps; ++i) fn(state);
+
+    std::vector<double> rep_ns;
+    uint64_t total_allocs = 0;
+    for (int i = 0; i < options.reps; ++i) {
+      uint64_t allocs_before = alloc_count();
+      auto start = Clock::now();
+      fn(state);
+      auto stop = Clock::now();
+      total_allocs += alloc_count() - allocs_before;
+      rep_ns.push_back(
+          std::chrono::duration<double, std::nano>(stop - start).count());
+    }
+    std::sort(rep_ns.begin(), rep_ns.end());
+
+    Result r;
+    r.name = name;
+    r.reps = options.reps;
+    r.p50_ns = percentile(rep_ns, 0.50);
+    r.p99_ns = percentile(rep_ns, 0.99);
+    uint64_t ops = state.ops() > 0 ? state.ops() : 1;
+    r.ns_per_op = r.p50_ns / static_cast<double>(ops);
+    r.allocs_per_op = static_cast<double>(total_allocs) /
+                      (static_cast<double>(options.reps) * ops);
+    if (state.bytes() > 0 && r.p50_ns > 0) {
+      r.bytes_per_sec = static_cast<double>(state.bytes()) * 1e9 / r.p50_ns;
+    }
+    results.push_back(r);
+    std::printf("%-36s %12.1f ns/op %10.1f MB/s %8.2f allocs/op\n",
+                r.name.c_str(), r.ns_per_op, r.bytes_per_sec / 1e6,
+                r.allocs_per_op);
+  }
+
+  std::FILE* out = fopen(options.output_path.c_str(), "w");
+  if (out == nullptr) return false;
+  for (const Result& r : results) {
+    fprintf(out,
+            "bench name=%s ns_op=%.2f bytes_s=%.0f allocs_op=%.3f "
+            "p50_ns=%.0f p99_ns=%.0f reps=%d\n",
+            r.name.c_str(), r.ns_per_op, r.bytes_per_sec, r.allocs_per_op,
+            r.p50_ns, r.p99_ns, r.reps);
+  }
+  fclose(out);
+  return true;
+}
+
+namespace {
+
+struct SampleStats {
+  double mean = 0;
+  double ci_half = 0;  // 95% half-width
+};
+
+// Two-tailed 95% critical values of Student's t; beyond df 30 the
+// normal approximation is within a percent.
+double t_critical(double df) {
+  static const double kTable[] = {
+      12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+      2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+      2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+  if (df < 1) return kTable[0];
+  if (df <= 30) return kTable[static_cast<int>(df) - 1];
+  return 1.96;
+}
+
+double sample_mean(const std::vector<double>& xs) {
+  double sum = 0;
+  for (double x : xs) sum += x;
+  return sum / static_cast<double>(xs.size());
+}
+
+double sample_variance(const std::vector<double>& xs, double mean) {
+  if (xs.size() < 2) return 0;
+  double sum = 0;
+  for (double x : xs) sum += (x - mean) * (x - mean);
+  return sum / static_cast<double>(xs.size() - 1);
+}
+
+SampleStats stats_of(const std::vector<double>& xs) {
+  SampleStats s;
+  s.mean = sample_mean(xs);
+  double var = sample_variance(xs, s.mean);
+  double n = static_cast<double>(xs.size());
+  s.ci_half = t_critical(n - 1) * std::sqrt(var / n);
+  return s;
+}
+
+// Welch's t-test; true when the means differ at 95% confidence.
+bool significantly_different(const std::vector<double>& a,
+                             const std::vector<double>& b, double* t_out) {
+  double ma = sample_mean(a);
+  double mb = sample_mean(b);
+  double va = sample_variance(a, ma) / static_cast<double>(a.size());
+  double vb = sample_variance(b, mb) / static_cast<double>(b.size());
+  double se = std::sqrt(va + vb);
+  if (se == 0) {
+    *t_out = 0;
+    return ma != mb;
+  }
+  double t = (ma - mb) / se;
+  // Welch-Satterthwaite degrees of freedom.
+  double df = (va + vb) * (va + vb) /
+              (va * va / (static_cast<double>(a.size()) - 1) +
+               vb * vb / (static_cast<double>(b.size()) - 1));
+  *t_out = t;
+  return std::fabs(t) > t_critical(df);
+}
+
+struct ABMetric {
+  const char* name;
+  std::vector<double> a;
+  std::vector<double> b;
+};
+
+}  // namespace
+
+bool run_ab(const ABOptions& options) {
+  using Clock = std::chrono::steady_clock;
+  const BenchFn* fn_a = nullptr;
+  const BenchFn* fn_b = nullptr;
+  for (const auto& [name, fn] : registry()) {
+    if (name == options.bench_a) fn_a = &fn;
+    if (name == options.bench_b) fn_b = &fn;
+  }
+  if (fn_a == nullptr || fn_b == nullptr) {
+    std::fprintf(stderr, "unknown benchmark in A/B pair: %s vs %s\n",
+                 options.bench_a.c_str(), options.bench_b.c_str());
+    return false;
+  }
+
+  State state_a;
+  State state_b;
+  for (int i = 0; i < options.warmup_reps; ++i) {
+    (*fn_a)(state_a);
+    (*fn_b)(state_b);
+  }
+
+  ABMetric metrics[] = {{"ns_op", {}, {}}, {"bytes_s", {}, {}},
+                        {"allocs_op", {}, {}}};
+  auto one_rep = [&](const BenchFn& fn, State& state, size_t side) {
+    uint64_t allocs_before = alloc_count();
+    auto start = Clock::now();
+    fn(state);
+    auto stop = Clock::now();
+    double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+    uint64_t allocs = alloc_count() - allocs_before;
+    double ops = state.ops() > 0 ? static_cast<double>(state.ops()) : 1;
+    std::vector<double>* samples[] = {&metrics[0].a, &metrics[1].a,
+                                      &metrics[2].a};
+    if (side == 1) {
+      samples[0] = &metrics[0].b;
+      samples[1] = &metrics[1].b;
+      samples[2] = &metrics[2].b;
+    }
+    samples[0]->push_back(ns / ops);
+    samples[1]->push_back(state.bytes() > 0 && ns > 0
+                              ? static_cast<double>(state.bytes()) * 1e9 / ns
+                              : 0);
+    samples[2]->push_back(static_cast<double>(allocs) / ops);
+  };
+  // Interleaved so slow drift lands on both sides.
+  for (int i = 0; i < options.reps; ++i) {
+    one_rep(*fn_a, state_a, 0);
+    one_rep(*fn_b, state_b, 1);
+  }
+
+  std::FILE* out = fopen(options.output_path.c_str(), "w");
+  if (out == nullptr) return false;
+  std::printf("A/B: %s vs %s (%d reps each, interleaved)\n",
+              options.bench_a.c_str(), options.bench_b.c_str(), options.reps);
+  std::printf("%-10s %16s %16s %9s %12s\n", "metric", "A mean±95%", "B mean±95%",
+              "delta", "verdict");
+  bool ok = true;
+  for (const ABMetric& m : metrics) {
+    SampleStats sa = stats_of(m.a);
+    SampleStats sb = stats_of(m.b);
+    double t = 0;
+    bool significant = significantly_different(m.a, m.b, &t);
+    double delta_pct =
+        sa.mean != 0 ? (sb.mean - sa.mean) / sa.mean * 100.0 : 0;
+    const char* verdict = significant ? "significant" : "not_significant";
+    std::printf("%-10s %9.1f±%-6.1f %9.1f±%-6.1f %+8.1f%% %12s\n", m.name,
+                sa.mean, sa.ci_half, sb.mean, sb.ci_half, delta_pct, verdict);
+    ok = ok &&
+         fprintf(out,
+                 "ab metric=%s a=%s b=%s mean_a=%.2f ci_a=%.2f mean_b=%.2f "
+                 "ci_b=%.2f delta_pct=%+.2f t=%.2f reps=%d verdict=%s\n",
+                 m.name, options.bench_a.c_str(), options.bench_b.c_str(),
+                 sa.mean, sa.ci_half, sb.mean, sb.ci_half, delta_pct, t,
+                 options.reps, verdict) > 0;
+  }
+  if (fclose(out) != 0) ok = false;
+  return ok;
+}
+
+}  // namespace proga::bench
+
+// Allocation interposition for allocs/op. Only linked into the bench
+// binary, so the library itself stays untouched.
+void* operator new(size_t size) {
+  proga::bench::g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+  void* p = malloc(size);
+  if (p == nullptr) throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
@@ -0,0 +1,88 @@
+#pragma once
+
+// Microbenchmark harness. Benchmarks register with BENCHMARK(name) and
+// run under run_all(): warmup passes first, then timed repetitions,
+// with per-rep wall time, per-op heap allocation counts (the bench
+// binary interposes operator new), and throughput derived from the
+// bytes the benchmark reports. Results go to stdout and, in
+// machine-readable key=value lines, to bench_output.txt.
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace proga::bench {
+
+// Passed to each benchmark body. One invocation of the body is one
+// "op" unless it reports a different op count.
+class State {
+ public:
+  // Total payload bytes one rep touches; drives the bytes/s metric.
+  void set_bytes(uint64_t bytes) { bytes_ = bytes; }
+  // Number of logical ops one rep performs (e.g. records parsed).
+  void set_ops(uint64_t ops) { ops_ = ops; }
+
+  uint64_t bytes() const { return bytes_; }
+  uint64_t ops() const { return ops_; }
+
+ private:
+  uint64_t bytes_ = 0;
+  uint64_t ops_ = 1;
+};
+
+struct Options {
+  int warmup_reps = 2;
+  int reps = 10;
+  std::string output_path = "bench_output.txt";
+};
+
+struct Result {
+  std::string name;
+  double ns_per_op = 0;    // median rep time / ops
+  double bytes_per_sec = 0;
+  double allocs_per_op = 0;
+  double p50_ns = 0;       // per-rep wall time percentiles
+  double p99_ns = 0;
+  int reps = 0;
+};
+
+using BenchFn = std::function<void(State&)>;
+
+struct Registrar {
+  Registrar(const char* name, BenchFn fn);
+};
+
+// Runs every registered benchmark and writes the report. Returns
+// false if the output file could not be written.
+bool run_all(const Options& options);
+
+// A/B comparison of two registered benchmarks. Reps are interleaved
+// A,B,A,B,... on the same corpus so drift (thermal, page cache,
+// background load) hits both sides equally, then each metric gets a
+// 95% confidence interval and a Welch's t-test verdict. The combined
+// table goes to stdout and, in `ab` key=value lines, to
+// bench_output.txt.
+struct ABOptions {
+  std::string bench_a;
+  std::string bench_b;
+  int warmup_reps = 2;
+  int reps = 20;  // per side
+  std::string output_path = "bench_output.txt";
+};
+
+// Returns false if either benchmark name is unknown or the output
+// file could not be written.
+bool run_ab(const ABOptions& options);
+
+// Heap allocation counter maintained by the interposed operator new.
+uint64_t alloc_count();
+
+}  // namespace proga::bench
+
+#define BENCHMARK(name)                                              \
+  static void proga_bench_##name(::proga::bench::State& state);      \
+  static ::proga::bench::Registrar proga_bench_registrar_##name(     \
+      #name, proga_bench_##name);                                    \
+  static void proga_bench_##name(::proga::bench::State& state)
@@ -0,0 +1,171 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "colbin/colbin.h"
+#include "corpus.h"
+#include "harness.h"
+#include "jsonl/batch.h"
+#include "jsonl/index.h"
+#include "jsonl/mmap_reader.h"
+#include "mem/arena.h"
+#include "pipeline/parallel_reader.h"
+
+namespace {
+
+std::string g_corpus_path = "bench_corpus.jsonl";
+uint64_t g_corpus_bytes = 0;
+
+uint64_t file_size(const std::string& path) {
+  auto f = proga::io::MmapFile::open(path);
+  return f ? f->size() : 0;
+}
+
+}  // namespace
+
+using namespace proga;
+
+BENCHMARK(ingest_file_reader) {
+  auto reader = jsonl::JsonlFileReader::open(g_corpus_path);
+  jsonl::RecordView rec;
+  uint64_t count = 0;
+  while (reader->next(rec)) ++count;
+  state.set_ops(count);
+  state.set_bytes(g_corpus_bytes);
+}
+
+BENCHMARK(ingest_mmap_reader) {
+  auto reader = jsonl::JsonlMmapReader::open(g_corpus_path);
+  jsonl::RecordView rec;
+  uint64_t count = 0;
+  while (reader->next(rec)) ++count;
+  state.set_ops(count);
+  state.set_bytes(g_corpus_bytes);
+}
+
+BENCHMARK(ingest_parallel_reader) {
+  auto reader = pipeline::ParallelJsonlReader::open(g_corpus_path);
+  jsonl::RecordView rec;
+  uint64_t count = 0;
+  while (reader->next(rec)) ++count;
+  state.set_ops(count);
+  state.set_bytes(g_corpus_bytes);
+}
+
+BENCHMARK(parse_one_field_per_record) {
+  auto reader = jsonl::JsonlMmapReader::open(g_corpus_path);
+  jsonl::RecordView rec;
+  uint64_t count = 0;
+  int64_t sum = 0;
+  while (reader->next(rec)) {
+    sum += rec.int_field("latency_ms").value_or(0);
+    ++count;
+  }
+  state.set_ops(count);
+  state.set_bytes(g_corpus_bytes);
+  if (sum == -1) std::abort();  // keep the loop observable
+}
+
+BENCHMARK(batch_fill_arena) {
+  auto reader = jsonl::JsonlMmapReader::open(g_corpus_path);
+  mem::Arena arena;
+  jsonl::RecordBatch batch(&arena);
+  uint64_t count = 0;
+  while (batch.fill(*reader, 1024) > 0) {
+    count += batch.size();
+    batch.clear();
+  }
+  state.set_ops(count);
+  state.set_bytes(g_corpus_bytes);
+}
+
+BENCHMARK(colbin_column_scan) {
+  auto reader = colbin::ColbinReader::open("bench_corpus.colbin");
+  auto latency = reader->column("latency_ms");
+  int64_t sum = 0;
+  for (int64_t v : latency->int64s()) sum += v;
+  state.set_ops(latency->size());
+  state.set_bytes(latency->size() * sizeof(int64_t));
+  if (sum == -1) std::abort();
+}
+
+BENCHMARK(index_random_seek) {
+  auto index = jsonl::JsonlIndex::open("bench_corpus.jsonl.idx");
+  uint64_t rng = 7;
+  uint64_t sum = 0;
+  constexpr int kSeeks = 10000;
+  for (int i = 0; i < kSeeks; ++i) {
+    sum += index->seek(bench::splitmix64(rng) % index->record_count())
+               .value_or(0);
+  }
+  state.set_ops(kSeeks);
+  if (sum == 1) std::abort();
+}
+
+int main(int argc, char** argv) {
+  bench::Options options;
+  bench::CorpusOptions corpus;
+  std::string ab_pair;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--records") == 0 && i + 1 < argc) {
+      corpus.records = strtoull(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc) {
+      options.reps = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+      options.output_path = argv[++i];
+    } else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+      if (!bench::parse_profile(argv[++i], corpus)) {
+        fprintf(stderr, "bad profile: %s\n", argv[i]);
+        return 2;
+      }
+    } else if (strcmp(argv[i], "--ab") == 0 && i + 1 < argc) {
+      ab_pair = argv[++i];
+    } else {
+      fprintf(stderr,
+              "usage: %s [--records N] [--reps R] [--output path] "
+              "[--profile k=v,...] [--ab nameA,nameB]\n",
+              argv[0]);
+      return 2;
+    }
+  }
+
+  fprintf(stderr, "generating corpus: %llu records\n",
+          static_cast<unsigned long long>(corpus.records));
+  if (!bench::write_corpus(g_corpus_path, corpus)) {
+    fprintf(stderr, "failed to write %s\n", g_corpus_path.c_str());
+    return 1;
+  }
+  g_corpus_bytes = file_size(g_corpus_path);
+  if (!colbin::compile(g_corpus_path, "bench_corpus.colbin") ||
+      !jsonl::JsonlIndex::build(g_corpus_path, "bench_corpus.jsonl.idx")) {
+    fprintf(stderr, "failed to build corpus sidecars\n");
+    return 1;
+  }
+
+  bool ok;
+  if (!ab_pair.empty()) {
+    size_t comma = ab_pair.find(',');
+    if (comma == std::string::npos || comma == 0 ||
+        comma + 1 == ab_pair.size()) {
+      fprintf(stderr, "--ab expects nameA,nameB\n");
+      return 2;
+    }
+    bench::ABOptions ab;
+    ab.bench_a = ab_pair.substr(0, comma);
+    ab.bench_b = ab_pair.substr(comma + 1);
+    ab.reps = options.reps > 1 ? options.reps : 2;
+    ab.output_path = options.output_path;
+    ok = bench::run_ab(ab);
+  } else {
+    ok = bench::run_all(options);
+  }
+  remove(g_corpus_path.c_str());
+  remove("bench_corpus.colbin");
+  remove("bench_corpus.jsonl.idx");
+  if (!ok) {
+    fprintf(stderr, "failed to write %s\n", options.output_path.c_str());
+    return 1;
+  }
+  return 0;
+}
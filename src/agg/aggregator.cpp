@@ -0,0 +1,86 @@
+#include "agg/aggregator.h"
+
+namespace proga::agg {
+
+Aggregator::Aggregator(Options options) : options_(std::move(options)) {}
+
+void Aggregator::add(const jsonl::RecordView& rec) {
+  ++records_;
+  std::string_view key = rec.string_field(options_.group_by).value_or("");
+  mem::InternTable::Symbol sym = keys_.intern(key);
+  if (sym >= groups_.size()) groups_.resize(sym + 1);
+  GroupState& group = groups_[sym];
+  ++group.count;
+  if (!options_.percentile_field.empty()) {
+    if (auto v = rec.double_field(options_.percentile_field)) {
+      group.latency.add(*v);
+    }
+  }
+  if (!options_.distinct_field.empty()) {
+    if (auto v = rec.field(options_.distinct_field)) {
+      group.distinct.add(*v);
+    }
+  }
+}
+
+void Aggregator::merge(const Aggregator& other) {
+  records_ += other.records_;
+  for (size_t sym = 0; sym < other.groups_.size(); ++sym) {
+    std::string_view key =
+        other.keys_.resolve(static_cast<mem::InternTable::Symbol>(sym));
+    mem::InternTable::Symbol local = keys_.intern(key);
+    if (local >= groups_.size()) groups_.resize(local + 1);
+    GroupState& group = groups_[local];
+    const GroupState& from = other.groups_[sym];
+    group.count += from.count;
+    group.latency.merge(from.latency);
+    group.distinct.merge(from.distinct);
+  }
+}
+
+std::vector<Aggregator::GroupResult> Aggregator::results() const {
+  std::vector<GroupResult> out;
+  out.reserve(groups_.size());
+  for (size_t sym = 0; sym < groups_.size(); ++sym) {
+    const GroupState& group = groups_[sym];
+    if (group.count == 0) continue;
+    GroupResult r;
+    r.key = keys_.resolve(static_cast<mem::InternTable::Symbol>(sym));
+    r.count = group.count;
+    r.p50 = group.latency.quantile(0.50);
+    r.p99 = group.latency.quantile(0.99);
+    r.distinct = group.distinct.estimate();
+    out.push_back(r);
+  }
+  return out;
+}
+
+void Aggregator::serialize(std::vector<uint8_t>& out) const {
+  util::put_u64(out, records_);
+  keys_.serialize(out);
+  util::put_u64(out, groups_.size());
+  for (const GroupState& group : groups_) {
+    util::put_u64(out, group.count);
+    group.latency.serialize(out);
+    group.distinct.serialize(out);
+  }
+}
+
+bool Aggregator::deserialize(util::BinaryCursor& in) {
+  if (records_ != 0 || !groups_.empty()) return false;
+  uint64_t group_count = 0;
+  if (!in.get_u64(records_) || !keys_.deserialize(in) ||
+      !in.get_u64(group_count)) {
+    return false;
+  }
+  groups_.resize(group_count);
+  for (GroupState& group : groups_) {
+    if (!in.get_u64(group.count) || !group.latency.deserialize(in) ||
+        !group.distinct.deserialize(in)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace proga::agg
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "agg/sketch.h"
+#include "jsonl/parser.h"
+#include "mem/intern.h"
+
+namespace proga::agg {
+
+// One-pass streaming aggregation over a record stream with bounded
+// memory: per-group counts, latency quantiles (DDSketch), and distinct
+// counts (HyperLogLog). Group keys are interned, so the group table is
+// the same open-addressing-plus-arena structure the rest of ingest
+// uses, and per-record cost is one intern plus sketch updates.
+//
+//   Aggregator agg({.group_by = "url", .percentile_field = "latency_ms",
+//                   .distinct_field = "user"});
+//   while (reader.next(rec)) agg.add(rec);
+//   for (const auto& g : agg.results()) ...
+class Aggregator {
+ public:
+  struct Options {
+    std::string group_by;          // string field to group on
+    std::string percentile_field;  // numeric field sketched per group
+    std::string distinct_field;    // field distinct-counted per group
+  };
+
+  struct GroupResult {
+    std::string_view key;
+    uint64_t count = 0;
+    double p50 = 0;
+    double p99 = 0;
+    double distinct = 0;
+  };
+
+  explicit Aggregator(Options options);
+
+  // Records missing the group field fall into the "" group.
+  void add(const jsonl::RecordView& rec);
+
+  // Merges another aggregator built with the same options (e.g. from
+  // another shard's pass).
+  void merge(const Aggregator& other);
+
+  size_t group_count() const { return groups_.size(); }
+  std::vector<GroupResult> results() const;
+  uint64_t records_seen() const { return records_; }
+
+  // Snapshot support for resumable replays: serialize() appends the
+  // full aggregation state (keys, per-group counts and sketches);
+  // deserialize() restores it into a freshly constructed aggregator
+  // with the same options.
+  void serialize(std::vector<uint8_t>& out) const;
+  bool deserialize(util::BinaryCursor& in);
+
+ private:
+  struct GroupState {
+    uint64_t count = 0;
+    DDSketch latency;
+    HyperLogLog distinct;
+  };
+
+  Options options_;
+  mem::InternTable keys_;
+  std::vector<GroupState> groups_;  // indexed by key symbol
+  uint64_t records_ = 0;
+};
+
+}  // namespace proga::agg
@@ -0,0 +1,170 @@
+#pragma once
+
+// Fixed-memory sketches for one-pass aggregation over unbounded
+// streams: DDSketch for quantiles with relative-error guarantees and
+// HyperLogLog for distinct counts. Both are mergeable, so per-shard
+// partial aggregates combine losslessly.
+
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <string_view>
+#include <vector>
+
+#include "util/binary.h"
+#include "util/hash.h"
+
+namespace proga::agg {
+
+// DDSketch (relative-error quantile sketch). Values map to
+// log-gamma-spaced buckets; quantile estimates are within
+// `relative_accuracy` of the true value. Memory is bounded: when the
+// bucket count exceeds the cap the lowest buckets collapse together,
+// which only degrades accuracy at the extreme low end.
+class DDSketch {
+ public:
+  explicit DDSketch(double relative_accuracy = 0.01,
+                    size_t max_buckets = 2048)
+      : gamma_((1 + relative_accuracy) / (1 - relative_accuracy)),
+        inv_log_gamma_(1.0 / std::log(gamma_)),
+        max_buckets_(max_buckets) {}
+
+  void add(double value) {
+    ++count_;
+    if (value <= 0) {
+      ++zero_count_;  // zero/negative latencies land in one bucket
+      return;
+    }
+    int index = static_cast<int>(std::ceil(std::log(value) * inv_log_gamma_));
+    ++buckets_[index];
+    if (buckets_.size() > max_buckets_) collapse_lowest();
+  }
+
+  // Estimated value at quantile q in [0, 1].
+  double quantile(double q) const {
+    if (count_ == 0) return 0;
+    uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(count_ - 1));
+    if (rank < zero_count_) return 0;
+    uint64_t cumulative = zero_count_;
+    for (const auto& [index, bucket_count] : buckets_) {
+      cumulative += bucket_count;
+      if (cumulative > rank) {
+        // Midpoint of the bucket's value range.
+        return 2 * std::pow(gamma_, index) / (gamma_ + 1);
+      }
+    }
+    return 2 * std::pow(gamma_, buckets_.rbegin()->first) / (gamma_ + 1);
+  }
+
+  void merge(const DDSketch& other) {
+    count_ += other.count_;
+    zero_count_ += other.zero_count_;
+    for (const auto& [index, bucket_count] : other.buckets_) {
+      buckets_[index] += bucket_count;
+    }
+    while (buckets_.size() > max_buckets_) collapse_lowest();
+  }
+
+  uint64_t count() const { return count_; }
+
+  // Snapshot support: counts and buckets only — accuracy parameters
+  // come from the constructor, so restore into a sketch built with the
+  // same settings.
+  void serialize(std::vector<uint8_t>& out) const {
+    util::put_u64(out, count_);
+    util::put_u64(out, zero_count_);
+    util::put_u64(out, buckets_.size());
+    for (const auto& [index, bucket_count] : buckets_) {
+      util::put_u64(out, static_cast<uint64_t>(static_cast<int64_t>(index)));
+      util::put_u64(out, bucket_count);
+    }
+  }
+
+  bool deserialize(util::BinaryCursor& in) {
+    uint64_t bucket_count = 0;
+    if (!in.get_u64(count_) || !in.get_u64(zero_count_) ||
+        !in.get_u64(bucket_count)) {
+      return false;
+    }
+    buckets_.clear();
+    for (uint64_t i = 0; i < bucket_count; ++i) {
+      uint64_t index = 0, value = 0;
+      if (!in.get_u64(index) || !in.get_u64(value)) return false;
+      buckets_[static_cast<int>(static_cast<int64_t>(index))] = value;
+    }
+    return true;
+  }
+
+ private:
+  void collapse_lowest() {
+    auto first = buckets_.begin();
+    auto second = std::next(first);
+    second->second += first->second;
+    buckets_.erase(first);
+  }
+
+  double gamma_;
+  double inv_log_gamma_;
+  size_t max_buckets_;
+  std::map<int, uint64_t> buckets_;
+  uint64_t count_ = 0;
+  uint64_t zero_count_ = 0;
+};
+
+// HyperLogLog distinct counter, precision 12 (4096 single-byte
+// registers, ~1.6% standard error, 4 KiB per counter).
+class HyperLogLog {
+ public:
+  static constexpr int kPrecision = 12;
+  static constexpr size_t kRegisters = size_t{1} << kPrecision;
+
+  HyperLogLog() : registers_(kRegisters, 0) {}
+
+  void add(std::string_view value) { add_hash(util::xxhash64(value)); }
+
+  void add_hash(uint64_t hash) {
+    size_t index = hash >> (64 - kPrecision);
+    uint64_t rest = hash << kPrecision;
+    uint8_t rank =
+        rest == 0 ? static_cast<uint8_t>(64 - kPrecision + 1)
+                  : static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+    if (rank > registers_[index]) registers_[index] = rank;
+  }
+
+  double estimate() const {
+    double alpha = 0.7213 / (1 + 1.079 / static_cast<double>(kRegisters));
+    double sum = 0;
+    size_t zeros = 0;
+    for (uint8_t r : registers_) {
+      sum += std::ldexp(1.0, -r);
+      if (r == 0) ++zeros;
+    }
+    double m = static_cast<double>(kRegisters);
+    double raw = alpha * m * m / sum;
+    if (raw <= 2.5 * m && zeros > 0) {
+      return m * std::log(m / static_cast<double>(zeros));  // linear counting
+    }
+    return raw;
+  }
+
+  void merge(const HyperLogLog& other) {
+    for (size_t i = 0; i < kRegisters; ++i) {
+      if (other.registers_[i] > registers_[i]) {
+        registers_[i] = other.registers_[i];
+      }
+    }
+  }
+
+  void serialize(std::vector<uint8_t>& out) const {
+    util::put_bytes(out, registers_.data(), registers_.size());
+  }
+
+  bool deserialize(util::BinaryCursor& in) {
+    return in.get_bytes(registers_.data(), kRegisters);
+  }
+
+ private:
+  std::vector<uint8_t> registers_;
+};
+
+}  // namespace proga::agg
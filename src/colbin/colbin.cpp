@@ -0,0 +1,338 @@
+#include "colbin/colbin.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+#include "jsonl/mmap_reader.h"
+#include "jsonl/parser.h"
+
+namespace proga::colbin {
+
+namespace {
+
+constexpr char kMagic[8] = {'P', 'C', 'O', 'L', 'B', 'I', 'N', '1'};
+
+// In-memory accumulator for one column while compiling. Starts as the
+// narrowest type that fits and widens as values arrive: int64 ->
+// float64 -> string (raw JSON text for mixed-type keys).
+struct ColumnBuilder {
+  ColumnType type = ColumnType::kInt64;
+  size_t rows = 0;
+  std::vector<uint8_t> null_bitmap;
+  std::vector<int64_t> ints;
+  std::vector<double> floats;
+  std::vector<uint32_t> codes;
+  std::vector<std::string> dict;
+  std::unordered_map<std::string, uint32_t> dict_index;
+
+  void pad_to(size_t row_count) {
+    null_bitmap.resize((row_count + 7) / 8, 0);
+    while (rows < row_count) {
+      switch (type) {
+        case ColumnType::kInt64:
+          ints.push_back(0);
+          break;
+        case ColumnType::kFloat64:
+          floats.push_back(0.0);
+          break;
+        case ColumnType::kString:
+          codes.push_back(0);
+          break;
+      }
+      ++rows;
+    }
+  }
+
+  void widen_to_float() {
+    floats.reserve(ints.size());
+    for (int64_t v : ints) floats.push_back(static_cast<double>(v));
+    ints.clear();
+    type = ColumnType::kFloat64;
+  }
+
+  uint32_t intern(std::string_view s) {
+    auto it = dict_index.find(std::string(s));
+    if (it != dict_index.end()) return it->second;
+    uint32_t code = static_cast<uint32_t>(dict.size());
+    dict.emplace_back(s);
+    dict_index.emplace(dict.back(), code);
+    return code;
+  }
+
+  void widen_to_string() {
+    codes.reserve(rows);
+    char buf[32];
+    if (type == ColumnType::kInt64) {
+      for (int64_t v : ints) {
+        snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(v));
+        codes.push_back(intern(buf));
+      }
+      ints.clear();
+    } else if (type == ColumnType::kFloat64) {
+      for (double v : floats) {
+        snprintf(buf, sizeof(buf), "%.17g", v);
+        codes.push_back(intern(buf));
+      }
+      floats.clear();
+    }
+    type = ColumnType::kString;
+  }
+
+  // `raw` is the raw JSON value text from the record.
+  void append(size_t row, std::string_view raw) {
+    pad_to(row);
+    if (null_bitmap.size() <= (row >> 3)) null_bitmap.resize((row >> 3) + 1, 0);
+    null_bitmap[row >> 3] |= static_cast<uint8_t>(1u << (row & 7));
+    // Classify: integer, float, else string. String values drop their
+    // surrounding quotes; other JSON keeps its raw text. Numeric
+    // parses stay inside [raw.data(), raw.data() + raw.size()) — the
+    // view aliases the mapping, and a value ending on the mapping's
+    // last byte has no terminator after it.
+    if (type == ColumnType::kInt64) {
+      if (auto as_int = jsonl::detail::to_int64(raw)) {
+        ints.push_back(*as_int);
+        ++rows;
+        return;
+      }
+    }
+    char* end = nullptr;
+    char fbuf[64];
+    if (raw.size() < sizeof(fbuf) && type != ColumnType::kString) {
+      memcpy(fbuf, raw.data(), raw.size());
+      fbuf[raw.size()] = '\0';
+      errno = 0;
+      double as_float = strtod(fbuf, &end);
+      if (errno == 0 && end == fbuf + raw.size()) {
+        if (type == ColumnType::kInt64) widen_to_float();
+        floats.push_back(as_float);
+        ++rows;
+        return;
+      }
+    }
+    if (type != ColumnType::kString) widen_to_string();
+    std::string_view text = raw;
+    if (text.size() >= 2 && text.front() == '"' && text.back() == '"') {
+      text = text.substr(1, text.size() - 2);
+    }
+    codes.push_back(intern(text));
+    ++rows;
+  }
+};
+
+class Output {
+ public:
+  explicit Output(std::FILE* f) : f_(f) {}
+  bool ok() const { return ok_; }
+  uint64_t offset() const { return offset_; }
+
+  void write(const void* data, size_t n) {
+    if (ok_ && fwrite(data, 1, n, f_) != n) ok_ = false;
+    offset_ += n;
+  }
+  void put_u8(uint8_t v) { write(&v, 1); }
+  void put_u16(uint16_t v) { write(&v, 2); }
+  void put_u32(uint32_t v) { write(&v, 4); }
+  void put_u64(uint64_t v) { write(&v, 8); }
+  // Sections holding 8-byte values must start 8-byte aligned so the
+  // reader can alias them in place.
+  void align8() {
+    static const char zeros[8] = {};
+    write(zeros, (8 - offset_ % 8) % 8);
+  }
+
+ private:
+  std::FILE* f_;
+  uint64_t offset_ = 0;
+  bool ok_ = true;
+};
+
+struct ColumnLayout {
+  uint64_t bitmap_off = 0;
+  uint64_t values_off = 0;
+  uint64_t dict_blob_off = 0;
+  uint64_t dict_offsets_off = 0;
+  uint64_t dict_entries = 0;
+};
+
+const char* checked(const io::MmapFile& f, uint64_t off, uint64_t len) {
+  if (off > f.size() || len > f.size() - off) return nullptr;
+  return f.data() + off;
+}
+
+}  // namespace
+
+bool compile(const std::string& jsonl_path, const std::string& out_path) {
+  auto reader = jsonl::JsonlMmapReader::open(jsonl_path);
+  if (!reader) return false;
+
+  std::vector<std::string> names;
+  std::vector<ColumnBuilder> builders;
+  std::unordered_map<std::string, size_t> by_name;
+  size_t row = 0;
+  jsonl::RecordView rec;
+  while (reader->next(rec)) {
+    // Walk the record's top-level keys with the parser's own field
+    // iterator, which knows about escaped quotes and nested values —
+    // an ad-hoc quote scan would mis-split keys containing \".
+    std::string_view line = rec.raw();
+    const char* p = jsonl::detail::begin_fields(line);
+    if (p == nullptr) continue;
+    const char* end = line.data() + line.size();
+    std::string_view key_view;
+    std::string_view value;
+    while (jsonl::detail::next_field(p, end, key_view, value)) {
+      std::string key(key_view);
+      auto [it, inserted] = by_name.emplace(key, builders.size());
+      if (inserted) {
+        names.push_back(key);
+        builders.emplace_back();
+      }
+      builders[it->second].append(row, value);
+    }
+    ++row;
+  }
+  const size_t record_count = row;
+  for (auto& b : builders) b.pad_to(record_count);
+
+  std::FILE* f = fopen(out_path.c_str(), "wb");
+  if (f == nullptr) return false;
+  Output out(f);
+  out.write(kMagic, sizeof(kMagic));
+
+  std::vector<ColumnLayout> layouts(builders.size());
+  for (size_t i = 0; i < builders.size(); ++i) {
+    ColumnBuilder& b = builders[i];
+    ColumnLayout& lay = layouts[i];
+    out.align8();
+    lay.bitmap_off = out.offset();
+    out.write(b.null_bitmap.data(), b.null_bitmap.size());
+    out.align8();
+    lay.values_off = out.offset();
+    switch (b.type) {
+      case ColumnType::kInt64:
+        out.write(b.ints.data(), b.ints.size() * sizeof(int64_t));
+        break;
+      case ColumnType::kFloat64:
+        out.write(b.floats.data(), b.floats.size() * sizeof(double));
+        break;
+      case ColumnType::kString: {
+        out.write(b.codes.data(), b.codes.size() * sizeof(uint32_t));
+        out.align8();
+        lay.dict_blob_off = out.offset();
+        for (const std::string& s : b.dict) out.write(s.data(), s.size());
+        out.align8();
+        lay.dict_offsets_off = out.offset();
+        uint64_t pos = 0;
+        for (const std::string& s : b.dict) {
+          out.put_u64(pos);
+          pos += s.size();
+        }
+        out.put_u64(pos);
+        lay.dict_entries = b.dict.size();
+        break;
+      }
+    }
+  }
+
+  out.align8();
+  uint64_t footer_off = out.offset();
+  out.put_u64(record_count);
+  out.put_u32(static_cast<uint32_t>(builders.size()));
+  for (size_t i = 0; i < builders.size(); ++i) {
+    out.put_u16(static_cast<uint16_t>(names[i].size()));
+    out.write(names[i].data(), names[i].size());
+    out.put_u8(static_cast<uint8_t>(builders[i].type));
+    out.put_u64(layouts[i].bitmap_off);
+    out.put_u64(layouts[i].values_off);
+    out.put_u64(layouts[i].dict_blob_off);
+    out.put_u64(layouts[i].dict_offsets_off);
+    out.put_u64(layouts[i].dict_entries);
+  }
+  out.put_u64(footer_off);
+  out.write(kMagic, sizeof(kMagic));
+
+  bool ok = out.ok();
+  if (fclose(f) != 0) ok = false;
+  return ok;
+}
+
+std::string_view ColumnView::dict_entry(uint32_t code) const {
+  uint64_t begin = dict_offsets_[code];
+  uint64_t end = dict_offsets_[code + 1];
+  return std::string_view(dict_blob_ + begin, end - begin);
+}
+
+std::optional<ColbinReader> ColbinReader::open(const std::string& path) {
+  auto file = io::MmapFile::open(path, io::MmapFile::Advice::kSequential);
+  if (!file) return std::nullopt;
+  ColbinReader reader(std::move(*file));
+  if (!reader.parse_footer()) return std::nullopt;
+  return reader;
+}
+
+bool ColbinReader::parse_footer() {
+  const size_t min_size = sizeof(kMagic) * 2 + 8;
+  if (file_.size() < min_size) return false;
+  if (memcmp(file_.data(), kMagic, sizeof(kMagic)) != 0) return false;
+  if (memcmp(file_.data() + file_.size() - sizeof(kMagic), kMagic,
+             sizeof(kMagic)) != 0) {
+    return false;
+  }
+  uint64_t footer_off;
+  memcpy(&footer_off, file_.data() + file_.size() - sizeof(kMagic) - 8, 8);
+
+  const char* p = checked(file_, footer_off, 12);
+  if (p == nullptr) return false;
+  uint64_t records;
+  uint32_t column_count;
+  memcpy(&records, p, 8);
+  memcpy(&column_count, p + 8, 4);
+  record_count_ = records;
+  p += 12;
+  const char* end = file_.data() + file_.size();
+  for (uint32_t i = 0; i < column_count; ++i) {
+    if (p + 2 > end) return false;
+    uint16_t name_len;
+    memcpy(&name_len, p, 2);
+    p += 2;
+    if (p + name_len + 1 + 5 * 8 > end) return false;
+    names_.emplace_back(p, name_len);
+    p += name_len;
+    ColumnView col;
+    col.type_ = static_cast<ColumnType>(static_cast<uint8_t>(*p));
+    ++p;
+    uint64_t offs[5];
+    memcpy(offs, p, sizeof(offs));
+    p += sizeof(offs);
+    col.rows_ = record_count_;
+    size_t value_width = col.type_ == ColumnType::kString ? 4 : 8;
+    const char* bitmap = checked(file_, offs[0], (record_count_ + 7) / 8);
+    const char* values = checked(file_, offs[1], record_count_ * value_width);
+    if (bitmap == nullptr || values == nullptr) return false;
+    col.null_bitmap_ = reinterpret_cast<const uint8_t*>(bitmap);
+    col.values_ = values;
+    if (col.type_ == ColumnType::kString) {
+      col.dict_entries_ = offs[4];
+      const char* dict_offsets =
+          checked(file_, offs[3], (col.dict_entries_ + 1) * 8);
+      if (dict_offsets == nullptr) return false;
+      col.dict_offsets_ = reinterpret_cast<const uint64_t*>(dict_offsets);
+      col.dict_blob_ = checked(file_, offs[2],
+                               col.dict_offsets_[col.dict_entries_]);
+      if (col.dict_blob_ == nullptr) return false;
+    }
+    columns_.push_back(col);
+  }
+  return true;
+}
+
+std::optional<ColumnView> ColbinReader::column(std::string_view name) const {
+  for (size_t i = 0; i < names_.size(); ++i) {
+    if (names_[i] == name) return columns_[i];
+  }
+  return std::nullopt;
+}
+
+}  // namespace proga::colbin
@@ -0,0 +1,101 @@
+#pragma once
+
+// Columnar sidecar format compiled from a JSONL log ("colbin").
+//
+// Layout of a .colbin file:
+//
+//   [magic "PCOLBIN1"]
+//   per column: [null bitmap][values]            (i64/f64 columns)
+//               [null bitmap][u32 codes][dictionary blob][dict offsets]
+//                                                 (string columns)
+//   [footer: record count, column directory]
+//   [u64 footer offset][magic]
+//
+// The whole file is memory-mappable; the reader serves field scans as
+// typed spans straight out of the mapping with no per-record work.
+// Sidecars live next to the log and are gitignored like the other
+// generated artifacts.
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "io/mmap_file.h"
+
+namespace proga::colbin {
+
+enum class ColumnType : uint8_t {
+  kInt64 = 0,
+  kFloat64 = 1,
+  kString = 2,  // dictionary-encoded
+};
+
+// Compiles `jsonl_path` into a columnar sidecar at `out_path`.
+// Columns are inferred from the union of top-level keys; a key whose
+// values mix types is stored as a string column of raw JSON text.
+// Returns false on I/O or parse failure.
+bool compile(const std::string& jsonl_path, const std::string& out_path);
+
+// Read-only view of one column, aliasing the file mapping.
+class ColumnView {
+ public:
+  ColumnType type() const { return type_; }
+  size_t size() const { return rows_; }
+  bool is_null(size_t row) const {
+    return (null_bitmap_[row >> 3] & (1u << (row & 7))) == 0;
+  }
+
+  // Typed accessors; valid only for the matching type().
+  std::span<const int64_t> int64s() const {
+    return {reinterpret_cast<const int64_t*>(values_), rows_};
+  }
+  std::span<const double> float64s() const {
+    return {reinterpret_cast<const double*>(values_), rows_};
+  }
+  // Dictionary code per row, and the string a code maps to.
+  std::span<const uint32_t> codes() const {
+    return {reinterpret_cast<const uint32_t*>(values_), rows_};
+  }
+  size_t dict_size() const { return dict_entries_; }
+  std::string_view dict_entry(uint32_t code) const;
+  std::string_view string_at(size_t row) const {
+    return dict_entry(codes()[row]);
+  }
+
+ private:
+  friend class ColbinReader;
+  ColumnType type_ = ColumnType::kInt64;
+  size_t rows_ = 0;
+  const uint8_t* null_bitmap_ = nullptr;
+  const char* values_ = nullptr;
+  const char* dict_blob_ = nullptr;
+  const uint64_t* dict_offsets_ = nullptr;  // dict_entries_ + 1 entries
+  size_t dict_entries_ = 0;
+};
+
+// Maps a sidecar and resolves columns by name.
+class ColbinReader {
+ public:
+  // Returns nullopt if the file is missing, truncated, or has a bad
+  // magic/footer.
+  static std::optional<ColbinReader> open(const std::string& path);
+
+  size_t record_count() const { return record_count_; }
+  size_t column_count() const { return columns_.size(); }
+  std::optional<ColumnView> column(std::string_view name) const;
+  const std::vector<std::string>& column_names() const { return names_; }
+
+ private:
+  ColbinReader(io::MmapFile file) : file_(std::move(file)) {}
+  bool parse_footer();
+
+  io::MmapFile file_;
+  size_t record_count_ = 0;
+  std::vector<std::string> names_;
+  std::vector<ColumnView> columns_;
+};
+
+}  // namespace proga::colbin
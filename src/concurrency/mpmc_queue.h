@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <utility>
+
+namespace proga::concurrency {
+
+// Bounded lock-free multi-producer/multi-consumer ring (Vyukov's
+// sequence-number scheme). Each slot carries its own sequence counter
+// on a dedicated cache line, so producers and consumers contend only
+// on the slot they're claiming, not on shared head/tail locks. This is
+// the primitive that connects pipeline stages (parse -> enrich ->
+// aggregate -> emit); record handles, not records, travel through it.
+template <typename T>
+class MpmcQueue {
+ public:
+  // `capacity` is rounded up to a power of two.
+  explicit MpmcQueue(size_t capacity) {
+    size_t cap = 2;
+    while (cap < capacity) cap <<= 1;
+    mask_ = cap - 1;
+    slots_ = std::make_unique<Slot[]>(cap);
+    for (size_t i = 0; i < cap; ++i) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MpmcQueue(const MpmcQueue&) = delete;
+  MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+  // Returns false if the queue is full; a moved-in value is left
+  // untouched on failure.
+  bool try_push(T&& value) {
+    size_t pos = head_.load(std::memory_order_relaxed);
+    for (;;) {
+      Slot& slot = slots_[pos & mask_];
+      size_t seq = slot.sequence.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (head_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          slot.value = std::move(value);
+          slot.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;  // full
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+  bool try_push(const T& value) {
+    T copy(value);
+    return try_push(std::move(copy));
+  }
+
+  // Returns false if the queue is empty.
+  bool try_pop(T& out) {
+    size_t pos = tail_.load(std::memory_order_relaxed);
+    for (;;) {
+      Slot& slot = slots_[pos & mask_];
+      size_t seq = slot.sequence.load(std::memory_order_acquire);
+      intptr_t diff =
+          static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (tail_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          out = std::move(slot.value);
+          slot.sequence.store(pos + mask_ + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;  // empty
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Batch variants amortize per-call overhead in pipeline stages.
+  // They move as many elements as they can and return the count.
+  size_t try_push_batch(std::span<T> values) {
+    size_t pushed = 0;
+    while (pushed < values.size() && try_push(std::move(values[pushed]))) {
+      ++pushed;
+    }
+    return pushed;
+  }
+
+  size_t try_pop_batch(T* out, size_t max) {
+    size_t popped = 0;
+    while (popped < max && try_pop(out[popped])) ++popped;
+    return popped;
+  }
+
+  size_t capacity() const { return mask_ + 1; }
+
+ private:
+  struct alignas(64) Slot {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  std::unique_ptr<Slot[]> slots_;
+  size_t mask_ = 0;
+  alignas(64) std::atomic<size_t> head_{0};  // producers claim here
+  alignas(64) std::atomic<size_t> tail_{0};  // consumers claim here
+};
+
+}  // namespace proga::concurrency
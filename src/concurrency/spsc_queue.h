@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace proga::concurrency {
+
+// Bounded lock-free single-producer/single-consumer ring. Producer and
+// consumer indices sit on separate cache lines so the two sides don't
+// false-share; each side caches the other's index and refreshes it only
+// when the ring looks full/empty.
+template <typename T>
+class SpscQueue {
+ public:
+  // `capacity` is rounded up to a power of two.
+  explicit SpscQueue(size_t capacity) {
+    size_t cap = 1;
+    while (cap < capacity) cap <<= 1;
+    mask_ = cap - 1;
+    slots_.resize(cap);
+  }
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  // Producer side. Returns false if the ring is full; on failure a
+  // moved-in value is left untouched so the producer can retry.
+  bool try_push(T&& value) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (head - cached_tail_ > mask_) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      if (head - cached_tail_ > mask_) return false;
+    }
+    slots_[head & mask_] = std::move(value);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+  bool try_push(const T& value) {
+    T copy(value);
+    return try_push(std::move(copy));
+  }
+
+  // Consumer side. Returns false if the ring is empty.
+  bool try_pop(T& out) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == cached_head_) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+      if (tail == cached_head_) return false;
+    }
+    out = std::move(slots_[tail & mask_]);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  size_t capacity() const { return mask_ + 1; }
+
+ private:
+  std::vector<T> slots_;
+  size_t mask_ = 0;
+
+  alignas(64) std::atomic<size_t> head_{0};  // producer writes
+  size_t cached_tail_ = 0;                   // producer's view of tail_
+  alignas(64) std::atomic<size_t> tail_{0};  // consumer writes
+  size_t cached_head_ = 0;                   // consumer's view of head_
+};
+
+}  // namespace proga::concurrency
@@ -0,0 +1,348 @@
+#include "io/append_writer.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "util/hash.h"
+
+namespace proga::io {
+
+namespace {
+
+constexpr size_t kDirectAlign = 4096;
+
+// Canonical bytes for dedup hashing: surrounding whitespace and CRs
+// are transport artifacts, the payload bytes are what double-delivery
+// repeats.
+std::string_view canonicalize(std::string_view record) {
+  while (!record.empty() &&
+         (record.front() == ' ' || record.front() == '\t')) {
+    record.remove_prefix(1);
+  }
+  while (!record.empty() &&
+         (record.back() == ' ' || record.back() == '\t' ||
+          record.back() == '\r' || record.back() == '\n')) {
+    record.remove_suffix(1);
+  }
+  return record;
+}
+
+// Fixed-capacity byte buffer aligned for O_DIRECT.
+struct AlignedBuffer {
+  char* data = nullptr;
+  size_t size = 0;
+  size_t capacity = 0;
+
+  explicit AlignedBuffer(size_t cap) : capacity(cap) {
+    if (posix_memalign(reinterpret_cast<void**>(&data), kDirectAlign, cap) !=
+        0) {
+      data = nullptr;
+      capacity = 0;
+    }
+  }
+  ~AlignedBuffer() { free(data); }
+  AlignedBuffer(const AlignedBuffer&) = delete;
+  AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+};
+
+bool write_fully(int fd, const char* p, size_t n) {
+  while (n > 0) {
+    ssize_t written = ::write(fd, p, n);
+    if (written < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    p += written;
+    n -= static_cast<size_t>(written);
+  }
+  return true;
+}
+
+bool pwrite_fully(int fd, const char* p, size_t n, uint64_t offset) {
+  while (n > 0) {
+    ssize_t written = ::pwrite(fd, p, n, static_cast<off_t>(offset));
+    if (written < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    p += written;
+    n -= static_cast<size_t>(written);
+    offset += static_cast<uint64_t>(written);
+  }
+  return true;
+}
+
+}  // namespace
+
+struct AppendWriter::Impl {
+  int fd = -1;
+  Options options;
+  bool direct = false;
+
+  std::mutex mu;
+  std::condition_variable producer_cv;  // signalled when active drains
+  std::condition_variable flusher_cv;   // signalled when work arrives
+  AlignedBuffer active;   // producers append here
+  AlignedBuffer staging;  // flusher writes from here
+  // Direct mode tracks its own offset (no O_APPEND) so a flush that
+  // leaves the file at a sub-block length can be continued by
+  // rewriting that last partial block at its aligned offset. `partial`
+  // holds the bytes already on disk past the last block boundary.
+  uint64_t file_offset = 0;
+  AlignedBuffer partial;
+  size_t partial_len = 0;
+  bool stop = false;
+  bool flush_requested = false;
+  bool io_error = false;
+  uint64_t flush_generation = 0;  // completed flush passes
+  std::atomic<uint64_t> bytes_written{0};
+  std::atomic<uint64_t> records{0};
+  std::atomic<uint64_t> deduped{0};
+  // Direct-mapped recent-hash cache (see Options::dedup_window); empty
+  // when dedup is off. Slot 0 means "never written".
+  std::vector<std::atomic<uint64_t>> dedup_cache;
+  size_t dedup_mask = 0;
+  std::thread flusher;
+
+  explicit Impl(const Options& opts)
+      : options(opts),
+        active(opts.buffer_bytes),
+        staging(opts.buffer_bytes),
+        partial(kDirectAlign) {
+    if (opts.dedup_window > 0) {
+      size_t cap = 64;
+      while (cap < opts.dedup_window) cap <<= 1;
+      dedup_cache = std::vector<std::atomic<uint64_t>>(cap);
+      dedup_mask = cap - 1;
+    }
+  }
+
+  // True when the record repeats a recent append. Lock-free: one
+  // relaxed load and store on the slot its hash maps to.
+  bool is_duplicate(std::string_view record) {
+    uint64_t h = util::xxhash64(canonicalize(record));
+    if (h == 0) h = 1;  // keep 0 as the empty-slot sentinel
+    std::atomic<uint64_t>& slot = dedup_cache[h & dedup_mask];
+    if (slot.load(std::memory_order_relaxed) == h) {
+      deduped.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+    slot.store(h, std::memory_order_relaxed);
+    return false;
+  }
+
+  ~Impl() {
+    {
+      std::unique_lock<std::mutex> lock(mu);
+      stop = true;
+      flusher_cv.notify_one();
+    }
+    if (flusher.joinable()) flusher.join();
+    if (fd >= 0) ::close(fd);
+  }
+
+  // Writes staging.size bytes. Buffered mode appends as-is. Direct
+  // mode writes at a tracked offset: staging begins with the
+  // partial_len bytes already on disk past the last block boundary
+  // (a drain may leave the file at any length), so every write starts
+  // block-aligned — whole blocks go out with O_DIRECT, a sub-block
+  // tail with O_DIRECT temporarily cleared, and the tail bytes are
+  // kept to head the next write's rewrite of that block.
+  bool write_staging() {
+    size_t n = staging.size;
+    if (!direct) {
+      if (!write_fully(fd, staging.data, n)) return false;
+      bytes_written.fetch_add(n, std::memory_order_relaxed);
+      staging.size = 0;
+      return true;
+    }
+    size_t pre = partial_len;  // rewritten bytes, not new payload
+    uint64_t offset = file_offset - pre;
+    size_t aligned = n & ~(kDirectAlign - 1);
+    if (aligned > 0 &&
+        !pwrite_fully(fd, staging.data, aligned, offset)) {
+      return false;
+    }
+    size_t tail = n - aligned;
+    if (tail > 0) {
+      int flags = fcntl(fd, F_GETFL);
+      fcntl(fd, F_SETFL, flags & ~O_DIRECT);
+      bool ok = pwrite_fully(fd, staging.data + aligned, tail,
+                             offset + aligned);
+      fcntl(fd, F_SETFL, flags);
+      if (!ok) return false;
+    }
+    bytes_written.fetch_add(n - pre, std::memory_order_relaxed);
+    file_offset = offset + n;
+    partial_len = static_cast<size_t>(file_offset & (kDirectAlign - 1));
+    if (partial_len > 0) {
+      memcpy(partial.data, staging.data + n - partial_len, partial_len);
+    }
+    staging.size = 0;
+    return true;
+  }
+
+  void flusher_loop() {
+    using Clock = std::chrono::steady_clock;
+    auto last_sync = Clock::now();
+    std::unique_lock<std::mutex> lock(mu);
+    for (;;) {
+      if (active.size == 0 && !stop && !flush_requested) {
+        if (options.sync_interval_ms > 0) {
+          flusher_cv.wait_for(
+              lock, std::chrono::milliseconds(options.sync_interval_ms));
+        } else {
+          flusher_cv.wait(lock);
+        }
+      }
+      bool draining = stop || flush_requested;
+      // Move pending bytes to staging so producers can refill while we
+      // write. Direct staging is headed by the on-disk partial block
+      // so writes start aligned; in steady state only whole blocks are
+      // taken and the sub-block remainder stays in `active` until more
+      // data or a drain arrives.
+      size_t pre = direct ? partial_len : 0;
+      size_t room = staging.capacity - pre;
+      size_t take = active.size < room ? active.size : room;
+      if (direct && !draining) {
+        size_t whole = (pre + take) & ~(kDirectAlign - 1);
+        take = whole > pre ? whole - pre : 0;
+      }
+      if (take > 0) {
+        if (pre > 0) memcpy(staging.data, partial.data, pre);
+        memcpy(staging.data + pre, active.data, take);
+        staging.size = pre + take;
+        size_t rest = active.size - take;
+        memmove(active.data, active.data + take, rest);
+        active.size = rest;
+        producer_cv.notify_all();
+      }
+      lock.unlock();
+      bool ok = true;
+      if (staging.size > 0) ok = write_staging();
+      auto now = Clock::now();
+      bool want_sync =
+          draining ||
+          (options.sync_interval_ms > 0 &&
+           now - last_sync >=
+               std::chrono::milliseconds(options.sync_interval_ms));
+      if (ok && want_sync) {
+        if (fdatasync(fd) != 0) ok = false;
+        last_sync = now;
+      }
+      lock.lock();
+      if (!ok) io_error = true;
+      if (draining && active.size == 0) {
+        ++flush_generation;
+        flush_requested = false;
+        producer_cv.notify_all();
+        if (stop) return;
+      }
+    }
+  }
+};
+
+std::optional<AppendWriter> AppendWriter::open(const std::string& path,
+                                               const Options& options) {
+  auto impl = std::make_unique<Impl>(options);
+  if (impl->active.data == nullptr || impl->staging.data == nullptr ||
+      impl->partial.data == nullptr) {
+    return std::nullopt;
+  }
+  if (options.direct_io) {
+    // No O_APPEND: direct writes go through pwrite at a tracked offset
+    // so the last partial block can be rewritten in place.
+    impl->fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_DIRECT, 0644);
+    impl->direct = impl->fd >= 0;
+    if (impl->direct) {
+      off_t end = lseek(impl->fd, 0, SEEK_END);
+      impl->file_offset = end > 0 ? static_cast<uint64_t>(end) : 0;
+      size_t pre =
+          static_cast<size_t>(impl->file_offset & (kDirectAlign - 1));
+      if (pre > 0) {
+        // Reload the existing sub-block tail through a plain fd.
+        int rfd = ::open(path.c_str(), O_RDONLY);
+        bool loaded =
+            rfd >= 0 &&
+            pread(rfd, impl->partial.data, pre,
+                  static_cast<off_t>(impl->file_offset - pre)) ==
+                static_cast<ssize_t>(pre);
+        if (rfd >= 0) ::close(rfd);
+        if (loaded) {
+          impl->partial_len = pre;
+        } else {
+          ::close(impl->fd);
+          impl->fd = -1;
+          impl->direct = false;
+        }
+      }
+    }
+  }
+  if (impl->fd < 0) {
+    impl->fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+  }
+  if (impl->fd < 0) return std::nullopt;
+  Impl* raw = impl.get();
+  impl->flusher = std::thread([raw] { raw->flusher_loop(); });
+  return AppendWriter(std::move(impl));
+}
+
+AppendWriter::AppendWriter(std::unique_ptr<Impl> impl)
+    : impl_(std::move(impl)) {}
+AppendWriter::AppendWriter(AppendWriter&&) noexcept = default;
+AppendWriter& AppendWriter::operator=(AppendWriter&&) noexcept = default;
+AppendWriter::~AppendWriter() = default;
+
+bool AppendWriter::append(std::string_view record) {
+  Impl& im = *impl_;
+  size_t need = record.size() + 1;
+  if (need > im.active.capacity) return false;
+  if (!im.dedup_cache.empty() && im.is_duplicate(record)) return true;
+  std::unique_lock<std::mutex> lock(im.mu);
+  while (im.active.size + need > im.active.capacity && !im.io_error) {
+    im.flusher_cv.notify_one();
+    im.producer_cv.wait(lock);
+  }
+  if (im.io_error) return false;
+  memcpy(im.active.data + im.active.size, record.data(), record.size());
+  im.active.data[im.active.size + record.size()] = '\n';
+  im.active.size += need;
+  im.records.fetch_add(1, std::memory_order_relaxed);
+  if (im.active.size >= im.active.capacity / 2) im.flusher_cv.notify_one();
+  return true;
+}
+
+bool AppendWriter::flush() {
+  Impl& im = *impl_;
+  std::unique_lock<std::mutex> lock(im.mu);
+  uint64_t target = im.flush_generation + 1;
+  im.flush_requested = true;
+  im.flusher_cv.notify_one();
+  im.producer_cv.wait(lock, [&] {
+    return im.flush_generation >= target || im.io_error;
+  });
+  return !im.io_error;
+}
+
+bool AppendWriter::ok() const { return impl_ && !impl_->io_error; }
+uint64_t AppendWriter::bytes_written() const {
+  return impl_->bytes_written.load(std::memory_order_relaxed);
+}
+uint64_t AppendWriter::records_appended() const {
+  return impl_->records.load(std::memory_order_relaxed);
+}
+uint64_t AppendWriter::records_deduped() const {
+  return impl_->deduped.load(std::memory_order_relaxed);
+}
+
+}  // namespace proga::io
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace proga::io {
+
+// High-throughput append writer for JSONL logs. append() copies the
+// record into an in-memory buffer and returns; a background flusher
+// issues large writes, so producers never wait on disk latency (only
+// on memory back-pressure when the flusher is an entire buffer
+// behind). Optional O_DIRECT keeps bulk writes out of the page cache,
+// and group commit fdatasyncs on a configurable interval instead of
+// per record.
+class AppendWriter {
+ public:
+  struct Options {
+    size_t buffer_bytes = 4 << 20;  // per half of the double buffer
+    bool direct_io = false;
+    // 0 disables group commit; otherwise the flusher fdatasyncs at
+    // most once per interval.
+    int sync_interval_ms = 0;
+    // When non-zero, a record whose bytes match one of roughly the
+    // last `dedup_window` appends is silently dropped (collectors
+    // occasionally double-deliver). The cache is a fixed-size
+    // direct-mapped table of xxHash values — lock-free, one load and
+    // one store per append — so the window is approximate: a hash
+    // landing on a reused slot forgets the older record early.
+    size_t dedup_window = 0;
+  };
+
+  // Opens (creating if needed) `path` for append. Returns nullopt on
+  // failure; with direct_io the open falls back to buffered I/O if the
+  // filesystem refuses O_DIRECT.
+  static std::optional<AppendWriter> open(const std::string& path,
+                                          const Options& options);
+  static std::optional<AppendWriter> open(const std::string& path) {
+    return open(path, Options());
+  }
+
+  AppendWriter(AppendWriter&&) noexcept;
+  AppendWriter& operator=(AppendWriter&&) noexcept;
+  ~AppendWriter();  // drains and closes
+
+  // Queues one record; a trailing newline is added. Returns false if
+  // the writer has hit an I/O error or the record exceeds the buffer.
+  // A record dropped by dedup still returns true: it was handled, just
+  // not written again.
+  bool append(std::string_view record);
+
+  // Blocks until everything queued so far is written and synced.
+  bool flush();
+
+  bool ok() const;
+  uint64_t bytes_written() const;
+  uint64_t records_appended() const;
+  // Duplicates dropped by the dedup cache; 0 when dedup is off.
+  uint64_t records_deduped() const;
+
+ private:
+  struct Impl;
+  explicit AppendWriter(std::unique_ptr<Impl> impl);
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace proga::io
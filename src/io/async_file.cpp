@@ -0,0 +1,300 @@
+#include "io/async_file.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "concurrency/spsc_queue.h"
+#include "util/instrument.h"
+
+#if defined(PROGA_HAVE_LIBURING)
+#include <liburing.h>
+#endif
+
+namespace proga::io {
+
+namespace {
+
+struct Block {
+  std::vector<char> data;
+  size_t size = 0;
+};
+
+}  // namespace
+
+struct AsyncFileReader::Impl {
+  int fd = -1;
+  Options options;
+  std::atomic<bool> io_error{false};
+  std::atomic<uint64_t> bytes{0};
+
+  // --- threaded pread fallback ---
+  concurrency::SpscQueue<std::unique_ptr<Block>> queue{1};
+  std::unique_ptr<std::atomic<bool>> stop =
+      std::make_unique<std::atomic<bool>>(false);
+  std::thread prefetcher;
+  std::unique_ptr<Block> current;
+
+#if defined(PROGA_HAVE_LIBURING)
+  // --- io_uring backend ---
+  bool use_uring = false;
+  struct io_uring ring;
+  std::vector<Block> slots;      // one registered buffer per sqe slot
+  std::vector<struct iovec> iovecs;
+  // Per-slot completion state: CQEs can land in any order, so a
+  // consumed CQE parks its result here until deliver_index reaches it.
+  std::vector<uint64_t> slot_order;
+  std::vector<int> slot_res;
+  std::vector<bool> slot_done;
+  uint64_t submit_offset = 0;    // next file offset to queue
+  uint64_t deliver_index = 0;    // next block (by order) to hand out
+  uint64_t submitted = 0;
+  int pending_requeue = -1;      // delivered slot awaiting reuse
+  bool submit_done = false;      // EOF observed; stop queueing reads
+#endif
+
+  explicit Impl(const Options& opts)
+      : options(opts), queue(opts.queue_depth) {}
+
+  ~Impl() {
+    // A prefetcher blocked on a full queue watches the stop flag.
+    stop->store(true, std::memory_order_relaxed);
+    if (prefetcher.joinable()) prefetcher.join();
+#if defined(PROGA_HAVE_LIBURING)
+    if (use_uring) io_uring_queue_exit(&ring);
+#endif
+    if (fd >= 0) ::close(fd);
+  }
+
+  void prefetch_loop() {
+    uint64_t offset = 0;
+    for (;;) {
+      auto block = std::make_unique<Block>();
+      block->data.resize(options.block_bytes);
+      ssize_t n = pread(fd, block->data.data(), options.block_bytes,
+                        static_cast<off_t>(offset));
+      if (n < 0) {
+        if (errno == EINTR) continue;
+        io_error.store(true, std::memory_order_relaxed);
+        n = 0;
+      }
+      block->size = static_cast<size_t>(n);
+      offset += static_cast<uint64_t>(n);
+      bool last = block->size == 0;
+      while (!queue.try_push(std::move(block))) {
+        if (stop->load(std::memory_order_relaxed)) return;
+        std::this_thread::yield();
+      }
+      if (last) return;  // empty block marks EOF
+    }
+  }
+
+  bool next_block_fallback(std::string_view& out) {
+    std::unique_ptr<Block> block;
+    while (!queue.try_pop(block)) {
+      if (io_error.load(std::memory_order_relaxed)) return false;
+      std::this_thread::yield();
+    }
+    if (block->size == 0) return false;  // EOF marker
+    bytes.fetch_add(block->size, std::memory_order_relaxed);
+    current = std::move(block);
+    out = std::string_view(current->data.data(), current->size);
+    return true;
+  }
+
+#if defined(PROGA_HAVE_LIBURING)
+  bool init_uring() {
+    if (io_uring_queue_init(options.queue_depth, &ring, 0) != 0) return false;
+    slots.resize(options.queue_depth);
+    iovecs.resize(options.queue_depth);
+    slot_order.resize(options.queue_depth, 0);
+    slot_res.resize(options.queue_depth, 0);
+    slot_done.resize(options.queue_depth, false);
+    for (unsigned i = 0; i < options.queue_depth; ++i) {
+      slots[i].data.resize(options.block_bytes);
+      iovecs[i].iov_base = slots[i].data.data();
+      iovecs[i].iov_len = options.block_bytes;
+    }
+    if (io_uring_register_buffers(&ring, iovecs.data(),
+                                  options.queue_depth) != 0) {
+      io_uring_queue_exit(&ring);
+      return false;
+    }
+    // Prime the queue: one read per slot.
+    for (unsigned i = 0; i < options.queue_depth; ++i) queue_read(i);
+    io_uring_submit(&ring);
+    return true;
+  }
+
+  void queue_read(unsigned slot) {
+    struct io_uring_sqe* sqe = io_uring_get_sqe(&ring);
+    if (sqe == nullptr) return;
+    io_uring_prep_read_fixed(sqe, fd, slots[slot].data.data(),
+                             options.block_bytes,
+                             static_cast<off_t>(submit_offset), slot);
+    // user_data carries (block order index << 8 | slot).
+    io_uring_sqe_set_data64(sqe, (submitted << 8) | slot);
+    submit_offset += options.block_bytes;
+    ++submitted;
+  }
+
+  bool next_block_uring(std::string_view& out) {
+    // The block handed out last call is consumed now; its buffer is
+    // free to reuse.
+    if (pending_requeue >= 0) {
+      if (!submit_done) {
+        queue_read(static_cast<unsigned>(pending_requeue));
+        io_uring_submit(&ring);
+      }
+      pending_requeue = -1;
+    }
+    // Completions can arrive out of order: each CQE parks its result
+    // in the slot's completion state, and blocks are handed out
+    // strictly by order index. Check parked slots before waiting —
+    // a CQE is consumed exactly once, so the block for deliver_index
+    // may already be sitting here from an earlier wait.
+    for (;;) {
+      for (unsigned slot = 0; slot < slot_done.size(); ++slot) {
+        if (!slot_done[slot] || slot_order[slot] != deliver_index) continue;
+        slot_done[slot] = false;
+        int res = slot_res[slot];
+        ++deliver_index;
+        if (res == 0) return false;  // EOF
+        bytes.fetch_add(static_cast<uint64_t>(res),
+                        std::memory_order_relaxed);
+        out = std::string_view(slots[slot].data.data(),
+                               static_cast<size_t>(res));
+        // Requeue only after the caller is done with the view.
+        pending_requeue = static_cast<int>(slot);
+        return true;
+      }
+      struct io_uring_cqe* cqe = nullptr;
+      if (io_uring_wait_cqe(&ring, &cqe) != 0) return false;
+      uint64_t data = io_uring_cqe_get_data64(cqe);
+      uint64_t order = data >> 8;
+      unsigned slot = static_cast<unsigned>(data & 0xff);
+      int res = cqe->res;
+      io_uring_cqe_seen(&ring, cqe);
+      if (res < 0) {
+        io_error.store(true, std::memory_order_relaxed);
+        return false;
+      }
+      // A short or empty read means the file end is in flight; reads
+      // queued past it would only produce empty completions.
+      if (static_cast<size_t>(res) < options.block_bytes) submit_done = true;
+      slot_order[slot] = order;
+      slot_res[slot] = res;
+      slot_done[slot] = true;
+    }
+  }
+#endif
+};
+
+bool AsyncFileReader::uring_available() {
+#if defined(PROGA_HAVE_LIBURING)
+  struct io_uring probe;
+  if (io_uring_queue_init(2, &probe, 0) != 0) return false;
+  io_uring_queue_exit(&probe);
+  return true;
+#else
+  return false;
+#endif
+}
+
+std::optional<AsyncFileReader> AsyncFileReader::open(const std::string& path,
+                                                     const Options& options) {
+  Options clamped = options;
+  // user_data carries the slot in its low 8 bits (see queue_read).
+  if (clamped.queue_depth > 256) clamped.queue_depth = 256;
+  if (clamped.queue_depth == 0) clamped.queue_depth = 1;
+  auto impl = std::make_unique<Impl>(clamped);
+  impl->fd = ::open(path.c_str(), O_RDONLY);
+  if (impl->fd < 0) return std::nullopt;
+#if defined(PROGA_HAVE_LIBURING)
+  impl->use_uring = impl->init_uring();
+  if (impl->use_uring) return AsyncFileReader(std::move(impl));
+#endif
+  Impl* raw = impl.get();
+  impl->prefetcher = std::thread([raw] { raw->prefetch_loop(); });
+  return AsyncFileReader(std::move(impl));
+}
+
+AsyncFileReader::AsyncFileReader(std::unique_ptr<Impl> impl)
+    : impl_(std::move(impl)) {}
+AsyncFileReader::AsyncFileReader(AsyncFileReader&&) noexcept = default;
+AsyncFileReader& AsyncFileReader::operator=(AsyncFileReader&&) noexcept =
+    default;
+AsyncFileReader::~AsyncFileReader() = default;
+
+bool AsyncFileReader::next_block(std::string_view& out) {
+  PROGA_TIMED_SCOPE("io.async_block");
+#if defined(PROGA_HAVE_LIBURING)
+  if (impl_->use_uring) return impl_->next_block_uring(out);
+#endif
+  return impl_->next_block_fallback(out);
+}
+
+bool AsyncFileReader::ok() const {
+  return !impl_->io_error.load(std::memory_order_relaxed);
+}
+uint64_t AsyncFileReader::bytes_read() const {
+  return impl_->bytes.load(std::memory_order_relaxed);
+}
+
+std::optional<AsyncJsonlReader> AsyncJsonlReader::open(
+    const std::string& path, const AsyncFileReader::Options& options) {
+  auto reader = AsyncFileReader::open(path, options);
+  if (!reader) return std::nullopt;
+  return AsyncJsonlReader(std::move(*reader));
+}
+
+bool AsyncJsonlReader::next(jsonl::RecordView& out) {
+  for (;;) {
+    if (pos_ < block_.size()) {
+      const char* begin = block_.data() + pos_;
+      const char* nl =
+          jsonl::detail::find_byte(begin, block_.size() - pos_, '\n');
+      if (nl != nullptr) {
+        size_t len = static_cast<size_t>(nl - begin);
+        pos_ += len + 1;
+        std::string_view line(begin, len);
+        if (!carry_.empty()) {
+          carry_.append(line);
+          line_buf_ = std::move(carry_);
+          carry_.clear();
+          line = line_buf_;
+        }
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (line.empty()) continue;
+        out = jsonl::RecordView(line);
+        ++records_;
+        return true;
+      }
+      carry_.append(begin, block_.size() - pos_);
+      pos_ = block_.size();
+    }
+    if (eof_) {
+      if (carry_.empty()) return false;
+      line_buf_ = std::move(carry_);
+      carry_.clear();
+      if (!line_buf_.empty() && line_buf_.back() == '\r') line_buf_.pop_back();
+      if (line_buf_.empty()) return false;
+      out = jsonl::RecordView(line_buf_);
+      ++records_;
+      return true;
+    }
+    if (!reader_.next_block(block_)) {
+      eof_ = true;
+      block_ = {};
+      pos_ = 0;
+      continue;
+    }
+    pos_ = 0;
+  }
+}
+
+}  // namespace proga::io
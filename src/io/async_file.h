@@ -0,0 +1,84 @@
+#pragma once
+
+// Asynchronous sequential file reads ahead of the parser.
+//
+// AsyncFileReader::next_block() hands out large blocks in file order
+// while the backend keeps queue_depth reads in flight. The backend is
+// io_uring with registered buffers when the library and kernel support
+// it (PROGA_HAVE_LIBURING); otherwise a prefetch thread issuing
+// pread(2) provides the same interface and read-ahead behaviour, and
+// is also the runtime fallback on kernels without io_uring.
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "jsonl/parser.h"
+
+namespace proga::io {
+
+class AsyncFileReader {
+ public:
+  struct Options {
+    size_t block_bytes = 1 << 20;
+    // In-flight reads. Capped at 256: the uring backend packs the
+    // buffer slot into the low 8 bits of user_data, and open() clamps
+    // larger values.
+    unsigned queue_depth = 8;
+  };
+
+  // True when this build has io_uring and the running kernel accepts
+  // ring setup.
+  static bool uring_available();
+
+  static std::optional<AsyncFileReader> open(const std::string& path,
+                                             const Options& options);
+  static std::optional<AsyncFileReader> open(const std::string& path) {
+    return open(path, Options());
+  }
+
+  AsyncFileReader(AsyncFileReader&&) noexcept;
+  AsyncFileReader& operator=(AsyncFileReader&&) noexcept;
+  ~AsyncFileReader();
+
+  // Next block in file order; the view is valid until the following
+  // call. Returns false at EOF or on I/O error (ok() distinguishes).
+  bool next_block(std::string_view& out);
+
+  bool ok() const;
+  uint64_t bytes_read() const;
+
+ private:
+  struct Impl;
+  explicit AsyncFileReader(std::unique_ptr<Impl> impl);
+  std::unique_ptr<Impl> impl_;
+};
+
+// JSONL record stream over AsyncFileReader: reassembles lines that
+// straddle block boundaries. Views are valid until the next call, as
+// with JsonlFileReader.
+class AsyncJsonlReader {
+ public:
+  static std::optional<AsyncJsonlReader> open(
+      const std::string& path,
+      const AsyncFileReader::Options& options = AsyncFileReader::Options());
+
+  bool next(jsonl::RecordView& out);
+  size_t records_read() const { return records_; }
+
+ private:
+  explicit AsyncJsonlReader(AsyncFileReader reader)
+      : reader_(std::move(reader)) {}
+
+  AsyncFileReader reader_;
+  std::string_view block_;
+  size_t pos_ = 0;
+  std::string carry_;  // partial line from the previous block
+  std::string line_buf_;
+  bool eof_ = false;
+  size_t records_ = 0;
+};
+
+}  // namespace proga::io
@@ -0,0 +1,71 @@
+#include "io/mmap_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace proga::io {
+
+std::optional<MmapFile> MmapFile::open(const std::string& path,
+                                       const Options& options) {
+  auto file = open(path, options.advice);
+  if (file && options.huge_pages) file->advise_huge_pages();
+  return file;
+}
+
+std::optional<MmapFile> MmapFile::open(const std::string& path, Advice advice) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) return std::nullopt;
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    ::close(fd);
+    return std::nullopt;
+  }
+  size_t size = static_cast<size_t>(st.st_size);
+  if (size == 0) {
+    ::close(fd);
+    return MmapFile(nullptr, 0);
+  }
+  void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);  // the mapping keeps its own reference
+  if (data == MAP_FAILED) return std::nullopt;
+  MmapFile file(data, size);
+  file.advise(advice);
+  return file;
+}
+
+MmapFile::MmapFile(MmapFile&& other) noexcept
+    : data_(other.data_), size_(other.size_) {
+  other.data_ = nullptr;
+  other.size_ = 0;
+}
+
+MmapFile& MmapFile::operator=(MmapFile&& other) noexcept {
+  if (this != &other) {
+    if (data_ != nullptr) munmap(data_, size_);
+    data_ = other.data_;
+    size_ = other.size_;
+    other.data_ = nullptr;
+    other.size_ = 0;
+  }
+  return *this;
+}
+
+MmapFile::~MmapFile() {
+  if (data_ != nullptr) munmap(data_, size_);
+}
+
+void MmapFile::advise(Advice advice) {
+  if (data_ == nullptr || advice == Advice::kNone) return;
+  int hint = advice == Advice::kSequential ? MADV_SEQUENTIAL : MADV_RANDOM;
+  madvise(data_, size_, hint);
+}
+
+void MmapFile::advise_huge_pages() {
+#if defined(MADV_HUGEPAGE)
+  if (data_ != nullptr) madvise(data_, size_, MADV_HUGEPAGE);
+#endif
+}
+
+}  // namespace proga::io
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace proga::io {
+
+// Read-only memory mapping of a whole file. Consumers get
+// std::string_view slices straight into the mapping, so reading a log
+// this way never copies line bytes onto the heap.
+class MmapFile {
+ public:
+  // Access-pattern hint forwarded to madvise(2). Sequential is the
+  // right choice for full replay, Random for indexed lookup.
+  enum class Advice { kNone, kSequential, kRandom };
+
+  struct Options {
+    Advice advice = Advice::kNone;
+    // Ask the kernel to back the mapping with transparent huge pages
+    // (MADV_HUGEPAGE). On multi-GB logs this trims TLB misses during
+    // the first scan; where the kernel declines the hint it is a
+    // no-op, never a failure.
+    bool huge_pages = false;
+  };
+
+  // Maps `path` read-only. Returns nullopt on failure (errno is left
+  // set by open(2)/mmap(2)). An empty file maps successfully with
+  // size() == 0.
+  static std::optional<MmapFile> open(const std::string& path,
+                                      Advice advice = Advice::kNone);
+  static std::optional<MmapFile> open(const std::string& path,
+                                      const Options& options);
+
+  MmapFile(MmapFile&& other) noexcept;
+  MmapFile& operator=(MmapFile&& other) noexcept;
+  MmapFile(const MmapFile&) = delete;
+  MmapFile& operator=(const MmapFile&) = delete;
+  ~MmapFile();
+
+  std::string_view view() const {
+    return std::string_view(static_cast<const char*>(data_), size_);
+  }
+  const char* data() const { return static_cast<const char*>(data_); }
+  size_t size() const { return size_; }
+
+  // Re-applies an access hint, e.g. to switch a mapping opened for
+  // replay over to random indexed access.
+  void advise(Advice advice);
+
+  // Hints the kernel toward huge pages for this mapping; best effort.
+  void advise_huge_pages();
+
+ private:
+  MmapFile(void* data, size_t size) : data_(data), size_(size) {}
+
+  void* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+}  // namespace proga::io
@@ -0,0 +1,85 @@
+#include "io/prefault.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace proga::io {
+
+struct Prefaulter::Impl {
+  const char* data = nullptr;
+  size_t size = 0;
+  std::function<size_t()> cursor;
+  Options options;
+  size_t page_size = 4096;
+  std::atomic<size_t> touched{0};
+  std::unique_ptr<std::atomic<bool>> stop =
+      std::make_unique<std::atomic<bool>>(false);
+  std::mutex done_mu;
+  std::condition_variable done_cv;  // progress, for wait_complete()
+  bool finished = false;
+  std::thread toucher;
+
+  void loop() {
+    size_t next = 0;
+    while (!stop->load(std::memory_order_relaxed) && next < size) {
+      size_t target = std::min(size, cursor() + options.window_bytes);
+      if (next >= target) {
+        std::this_thread::sleep_for(
+            std::chrono::milliseconds(options.poll_interval_ms));
+        continue;
+      }
+      while (next < target && !stop->load(std::memory_order_relaxed)) {
+        // A volatile read per page is enough to take the fault; the
+        // byte itself is discarded.
+        [[maybe_unused]] volatile char byte = data[next];
+        next = std::min(size, next + page_size);
+        touched.store(next, std::memory_order_relaxed);
+      }
+      done_cv.notify_all();
+    }
+    std::unique_lock<std::mutex> lock(done_mu);
+    finished = true;
+    done_cv.notify_all();
+  }
+};
+
+Prefaulter::Prefaulter(const char* data, size_t size,
+                       std::function<size_t()> cursor, const Options& options)
+    : impl_(new Impl) {
+  impl_->data = data;
+  impl_->size = size;
+  impl_->cursor = std::move(cursor);
+  impl_->options = options;
+  long page = sysconf(_SC_PAGESIZE);
+  if (page > 0) impl_->page_size = static_cast<size_t>(page);
+  if (data != nullptr && size > 0) {
+    Impl* raw = impl_.get();
+    impl_->toucher = std::thread([raw] { raw->loop(); });
+  }
+}
+
+Prefaulter::~Prefaulter() {
+  impl_->stop->store(true, std::memory_order_relaxed);
+  if (impl_->toucher.joinable()) impl_->toucher.join();
+}
+
+size_t Prefaulter::bytes_touched() const {
+  return impl_->touched.load(std::memory_order_relaxed);
+}
+
+void Prefaulter::wait_complete() const {
+  if (!impl_->toucher.joinable()) return;  // empty mapping: no thread
+  std::unique_lock<std::mutex> lock(impl_->done_mu);
+  impl_->done_cv.wait(lock, [this] {
+    return impl_->finished ||
+           impl_->touched.load(std::memory_order_relaxed) >= impl_->size;
+  });
+}
+
+}  // namespace proga::io
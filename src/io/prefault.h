@@ -0,0 +1,53 @@
+#pragma once
+
+// Background page toucher for large mappings.
+//
+// The first sequential scan over a cold multi-GB mapping pays a page
+// fault every 4 KB, right on the parse critical path. Prefaulter runs
+// a thread that reads one byte per page inside a window ahead of the
+// consumer's cursor, so faults are taken off-thread before the parser
+// arrives. The cursor is sampled through a callback (typically the
+// reader's bytes_consumed()), so the toucher never runs unboundedly
+// ahead of slow consumers and never re-touches pages already passed.
+//
+// The mapping and the cursor callback's referents must outlive the
+// Prefaulter; the destructor stops and joins the thread.
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace proga::io {
+
+class Prefaulter {
+ public:
+  struct Options {
+    // How far ahead of the cursor pages are faulted in.
+    size_t window_bytes = 64 << 20;
+    // Sleep between cursor samples once the window is warm.
+    int poll_interval_ms = 1;
+  };
+
+  Prefaulter(const char* data, size_t size, std::function<size_t()> cursor,
+             const Options& options);
+  Prefaulter(const char* data, size_t size, std::function<size_t()> cursor)
+      : Prefaulter(data, size, std::move(cursor), Options()) {}
+  ~Prefaulter();  // stops and joins the toucher thread
+
+  Prefaulter(const Prefaulter&) = delete;
+  Prefaulter& operator=(const Prefaulter&) = delete;
+
+  // Bytes whose pages have been touched so far.
+  size_t bytes_touched() const;
+
+  // Blocks until the toucher has walked the entire mapping. Only
+  // returns once the cursor has advanced far enough for the window to
+  // reach the end (e.g. the consumer hit EOF).
+  void wait_complete() const;
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace proga::io
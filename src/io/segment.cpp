@@ -0,0 +1,308 @@
+#include "io/segment.h"
+
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "concurrency/spsc_queue.h"
+#include "io/mmap_file.h"
+
+#if defined(PROGA_HAVE_ZSTD)
+#include <zstd.h>
+#endif
+
+namespace proga::io {
+
+namespace {
+
+constexpr char kMagic[8] = {'P', 'S', 'E', 'G', '0', '0', '0', '1'};
+
+struct FrameEntry {
+  uint64_t offset;
+  uint64_t compressed_len;
+  uint64_t raw_len;
+  uint64_t records;
+};
+
+bool compress_frame(Codec codec, int level, const std::vector<char>& raw,
+                    std::vector<char>& out) {
+  switch (codec) {
+    case Codec::kNone:
+      out.assign(raw.begin(), raw.end());
+      return true;
+    case Codec::kZstd: {
+#if defined(PROGA_HAVE_ZSTD)
+      out.resize(ZSTD_compressBound(raw.size()));
+      size_t n = ZSTD_compress(out.data(), out.size(), raw.data(), raw.size(),
+                               level);
+      if (ZSTD_isError(n)) return false;
+      out.resize(n);
+      return true;
+#else
+      (void)level;
+      return false;
+#endif
+    }
+  }
+  return false;
+}
+
+bool decompress_frame(Codec codec, const char* src, size_t src_len,
+                      std::vector<char>& out, size_t raw_len) {
+  switch (codec) {
+    case Codec::kNone:
+      if (src_len != raw_len) return false;
+      out.assign(src, src + src_len);
+      return true;
+    case Codec::kZstd: {
+#if defined(PROGA_HAVE_ZSTD)
+      out.resize(raw_len);
+      size_t n = ZSTD_decompress(out.data(), raw_len, src, src_len);
+      return !ZSTD_isError(n) && n == raw_len;
+#else
+      return false;
+#endif
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+bool zstd_available() {
+#if defined(PROGA_HAVE_ZSTD)
+  return true;
+#else
+  return false;
+#endif
+}
+
+struct SegmentWriter::Impl {
+  std::FILE* file = nullptr;
+  Options options;
+  std::vector<char> raw;         // open frame
+  std::vector<char> compressed;  // scratch
+  std::vector<FrameEntry> frames;
+  uint64_t offset = 0;
+  uint64_t frame_records = 0;
+  uint64_t total_records = 0;
+  bool finished = false;
+  bool io_error = false;
+
+  ~Impl() {
+    if (file != nullptr) fclose(file);
+  }
+
+  bool write(const void* p, size_t n) {
+    if (fwrite(p, 1, n, file) != n) {
+      io_error = true;
+      return false;
+    }
+    offset += n;
+    return true;
+  }
+
+  bool cut_frame() {
+    if (raw.empty()) return true;
+    if (!compress_frame(options.codec, options.level, raw, compressed)) {
+      io_error = true;
+      return false;
+    }
+    FrameEntry entry{offset, compressed.size(), raw.size(), frame_records};
+    if (!write(compressed.data(), compressed.size())) return false;
+    frames.push_back(entry);
+    raw.clear();
+    frame_records = 0;
+    return true;
+  }
+};
+
+std::optional<SegmentWriter> SegmentWriter::open(const std::string& path,
+                                                 const Options& options) {
+  auto impl = std::make_unique<Impl>();
+  impl->options = options;
+  if (impl->options.codec == Codec::kZstd && !zstd_available()) {
+    impl->options.codec = Codec::kNone;
+  }
+  impl->file = fopen(path.c_str(), "wb");
+  if (impl->file == nullptr) return std::nullopt;
+  if (!impl->write(kMagic, sizeof(kMagic))) return std::nullopt;
+  uint8_t codec = static_cast<uint8_t>(impl->options.codec);
+  if (!impl->write(&codec, 1)) return std::nullopt;
+  return SegmentWriter(std::move(impl));
+}
+
+SegmentWriter::SegmentWriter(std::unique_ptr<Impl> impl)
+    : impl_(std::move(impl)) {}
+SegmentWriter::SegmentWriter(SegmentWriter&&) noexcept = default;
+SegmentWriter& SegmentWriter::operator=(SegmentWriter&&) noexcept = default;
+SegmentWriter::~SegmentWriter() = default;
+
+bool SegmentWriter::append(std::string_view record) {
+  Impl& im = *impl_;
+  if (im.finished || im.io_error) return false;
+  im.raw.insert(im.raw.end(), record.begin(), record.end());
+  im.raw.push_back('\n');
+  ++im.frame_records;
+  ++im.total_records;
+  if (im.raw.size() >= im.options.frame_raw_bytes) return im.cut_frame();
+  return true;
+}
+
+bool SegmentWriter::finish() {
+  Impl& im = *impl_;
+  if (im.finished || im.io_error) return false;
+  if (!im.cut_frame()) return false;
+  uint64_t footer_off = im.offset;
+  uint64_t frame_count = im.frames.size();
+  bool ok = im.write(&frame_count, 8);
+  for (const FrameEntry& f : im.frames) {
+    ok = ok && im.write(&f, sizeof(FrameEntry));
+  }
+  ok = ok && im.write(&footer_off, 8) && im.write(kMagic, sizeof(kMagic));
+  if (ok && fflush(im.file) != 0) ok = false;
+  im.finished = true;
+  return ok;
+}
+
+uint64_t SegmentWriter::records_written() const { return impl_->total_records; }
+uint64_t SegmentWriter::frames_written() const { return impl_->frames.size(); }
+
+// ---------------------------------------------------------------------------
+
+struct SegmentReader::Impl {
+  // One decoded frame travelling from a decoder to the consumer.
+  using FrameBuffer = std::unique_ptr<std::vector<char>>;
+  struct Decoder {
+    explicit Decoder(size_t capacity) : queue(capacity) {}
+    concurrency::SpscQueue<FrameBuffer> queue;
+    std::thread thread;
+  };
+
+  MmapFile file;
+  Codec codec = Codec::kNone;
+  std::vector<FrameEntry> frames;
+  std::vector<std::unique_ptr<Decoder>> decoders;
+  std::unique_ptr<std::atomic<bool>> stop =
+      std::make_unique<std::atomic<bool>>(false);
+
+  // Consumer state: the frame being iterated and the one to pop next.
+  FrameBuffer current;
+  jsonl::JsonlReader scanner{std::string_view()};
+  size_t next_frame = 0;
+  size_t records = 0;
+  bool failed = false;
+
+  explicit Impl(MmapFile f) : file(std::move(f)) {}
+
+  ~Impl() {
+    // Decoders blocked on a full queue watch the stop flag, so setting
+    // it is enough to let every thread run off the end.
+    stop->store(true, std::memory_order_relaxed);
+    for (auto& d : decoders) {
+      if (d->thread.joinable()) d->thread.join();
+    }
+  }
+
+  bool parse_footer() {
+    size_t min = sizeof(kMagic) * 2 + 1 + 16;
+    if (file.size() < min) return false;
+    if (memcmp(file.data(), kMagic, sizeof(kMagic)) != 0) return false;
+    if (memcmp(file.data() + file.size() - sizeof(kMagic), kMagic,
+               sizeof(kMagic)) != 0) {
+      return false;
+    }
+    codec = static_cast<Codec>(file.data()[sizeof(kMagic)]);
+    if (codec == Codec::kZstd && !zstd_available()) return false;
+    uint64_t footer_off;
+    memcpy(&footer_off, file.data() + file.size() - sizeof(kMagic) - 8, 8);
+    if (footer_off + 8 > file.size()) return false;
+    uint64_t frame_count;
+    memcpy(&frame_count, file.data() + footer_off, 8);
+    if (footer_off + 8 + frame_count * sizeof(FrameEntry) > file.size()) {
+      return false;
+    }
+    frames.resize(frame_count);
+    memcpy(frames.data(), file.data() + footer_off + 8,
+           frame_count * sizeof(FrameEntry));
+    for (const FrameEntry& f : frames) {
+      if (f.offset + f.compressed_len > file.size()) return false;
+    }
+    return true;
+  }
+
+  // Decoder thread: handles frames i, i + n, i + 2n, ...
+  void decode_loop(Decoder& self, size_t first, size_t step) {
+    for (size_t i = first; i < frames.size(); i += step) {
+      const FrameEntry& f = frames[i];
+      auto buf = std::make_unique<std::vector<char>>();
+      if (!decompress_frame(codec, file.data() + f.offset, f.compressed_len,
+                            *buf, f.raw_len)) {
+        buf->clear();  // empty frame signals decode failure downstream
+      }
+      while (!self.queue.try_push(std::move(buf))) {
+        if (stop->load(std::memory_order_relaxed)) return;
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  bool next(jsonl::RecordView& out) {
+    for (;;) {
+      if (scanner.next(out)) {
+        ++records;
+        return true;
+      }
+      if (failed || next_frame >= frames.size()) return false;
+      Decoder& d = *decoders[next_frame % decoders.size()];
+      FrameBuffer buf;
+      while (!d.queue.try_pop(buf)) std::this_thread::yield();
+      if (buf->empty() && frames[next_frame].raw_len != 0) {
+        failed = true;  // decode error
+        return false;
+      }
+      current = std::move(buf);
+      scanner = jsonl::JsonlReader(
+          std::string_view(current->data(), current->size()));
+      ++next_frame;
+    }
+  }
+};
+
+std::optional<SegmentReader> SegmentReader::open(const std::string& path,
+                                                 unsigned num_threads) {
+  auto file = MmapFile::open(path, MmapFile::Advice::kSequential);
+  if (!file) return std::nullopt;
+  auto impl = std::make_unique<Impl>(std::move(*file));
+  if (!impl->parse_footer()) return std::nullopt;
+  if (num_threads == 0) {
+    num_threads = std::thread::hardware_concurrency();
+    if (num_threads == 0) num_threads = 1;
+  }
+  if (num_threads > impl->frames.size() && !impl->frames.empty()) {
+    num_threads = static_cast<unsigned>(impl->frames.size());
+  }
+  if (num_threads == 0) num_threads = 1;
+  for (unsigned i = 0; i < num_threads; ++i) {
+    impl->decoders.push_back(std::make_unique<Impl::Decoder>(4));
+  }
+  Impl* raw = impl.get();
+  for (unsigned i = 0; i < num_threads; ++i) {
+    Impl::Decoder* d = impl->decoders[i].get();
+    raw->decoders[i]->thread = std::thread(
+        [raw, d, i, num_threads] { raw->decode_loop(*d, i, num_threads); });
+  }
+  return SegmentReader(std::move(impl));
+}
+
+SegmentReader::SegmentReader(std::unique_ptr<Impl> impl)
+    : impl_(std::move(impl)) {}
+SegmentReader::SegmentReader(SegmentReader&&) noexcept = default;
+SegmentReader& SegmentReader::operator=(SegmentReader&&) noexcept = default;
+SegmentReader::~SegmentReader() = default;
+
+bool SegmentReader::next(jsonl::RecordView& out) { return impl_->next(out); }
+size_t SegmentReader::records_read() const { return impl_->records; }
+
+}  // namespace proga::io
@@ -0,0 +1,93 @@
+#pragma once
+
+// Segmented log compression (.pseg).
+//
+// The writer cuts the record stream into frames of ~frame_raw_bytes,
+// always on record boundaries, compresses each frame independently,
+// and appends a frame index (file offset, compressed/raw sizes, record
+// count) in a footer. Independent frames are what make the reader
+// parallel: a worker pool decompresses frames concurrently while
+// delivery stays in record order.
+//
+// Frames are zstd-compressed when the library is available
+// (PROGA_HAVE_ZSTD); Codec::kNone stores frames raw and is always
+// supported, so the format and the parallel reader work without the
+// dependency. Opening a zstd segment in a build without zstd fails
+// cleanly at open().
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "jsonl/parser.h"
+
+namespace proga::io {
+
+enum class Codec : uint8_t {
+  kNone = 0,
+  kZstd = 1,
+};
+
+// True when this build can compress/decompress Codec::kZstd.
+bool zstd_available();
+
+class SegmentWriter {
+ public:
+  struct Options {
+    Codec codec = Codec::kZstd;  // falls back to kNone if unavailable
+    size_t frame_raw_bytes = 1 << 20;
+    int level = 3;  // zstd compression level
+  };
+
+  static std::optional<SegmentWriter> open(const std::string& path,
+                                           const Options& options);
+  static std::optional<SegmentWriter> open(const std::string& path) {
+    return open(path, Options());
+  }
+
+  SegmentWriter(SegmentWriter&&) noexcept;
+  SegmentWriter& operator=(SegmentWriter&&) noexcept;
+  ~SegmentWriter();
+
+  // Appends one record (newline added). Cuts a frame once the raw
+  // buffer reaches frame_raw_bytes.
+  bool append(std::string_view record);
+
+  // Flushes the open frame and writes the footer. Must be called
+  // before the segment is readable; further appends are invalid.
+  bool finish();
+
+  uint64_t records_written() const;
+  uint64_t frames_written() const;
+
+ private:
+  struct Impl;
+  explicit SegmentWriter(std::unique_ptr<Impl> impl);
+  std::unique_ptr<Impl> impl_;
+};
+
+// Streaming reader with parallel frame decompression. next() yields
+// records in log order; views stay valid until the reader moves past
+// the frame that contains them.
+class SegmentReader {
+ public:
+  // `num_threads` 0 means one decoder per hardware thread.
+  static std::optional<SegmentReader> open(const std::string& path,
+                                           unsigned num_threads = 0);
+
+  SegmentReader(SegmentReader&&) noexcept;
+  SegmentReader& operator=(SegmentReader&&) noexcept;
+  ~SegmentReader();
+
+  bool next(jsonl::RecordView& out);
+  size_t records_read() const;
+
+ private:
+  struct Impl;
+  explicit SegmentReader(std::unique_ptr<Impl> impl);
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace proga::io
@@ -0,0 +1,306 @@
+#include "io/sharded_log.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <thread>
+
+#include "concurrency/spsc_queue.h"
+#include "io/mmap_file.h"
+#include "util/hash.h"
+
+namespace proga::io {
+
+namespace {
+
+constexpr size_t kQueueCapacity = 4096;
+
+// "logs/requests.jsonl" -> "logs/requests"; other names pass through.
+std::string stem_of(const std::string& base_path) {
+  constexpr std::string_view kExt = ".jsonl";
+  if (base_path.size() > kExt.size() &&
+      base_path.compare(base_path.size() - kExt.size(), kExt.size(), kExt) ==
+          0) {
+    return base_path.substr(0, base_path.size() - kExt.size());
+  }
+  return base_path;
+}
+
+std::string shard_path(const std::string& stem, unsigned index) {
+  char suffix[32];
+  std::snprintf(suffix, sizeof(suffix), ".%04u.jsonl", index);
+  return stem + suffix;
+}
+
+std::string dir_of(const std::string& path) {
+  size_t slash = path.find_last_of('/');
+  return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+}
+
+}  // namespace
+
+std::optional<ShardedLogWriter> ShardedLogWriter::open(
+    const std::string& base_path, const Options& options) {
+  if (options.shard_count == 0) return std::nullopt;
+  if (options.partition == Partition::kHashField && options.hash_field.empty())
+    return std::nullopt;
+  std::string stem = stem_of(base_path);
+
+  std::vector<AppendWriter> shards;
+  shards.reserve(options.shard_count);
+  for (unsigned i = 0; i < options.shard_count; ++i) {
+    auto writer = AppendWriter::open(shard_path(stem, i),
+                                     options.shard_options);
+    if (!writer) return std::nullopt;
+    shards.push_back(std::move(*writer));
+  }
+
+  // Manifest paths are relative to the manifest's own directory so the
+  // log tree can be moved as a unit.
+  std::string manifest_path = stem + ".manifest";
+  std::string dir = dir_of(manifest_path);
+  std::ofstream manifest(manifest_path, std::ios::trunc);
+  if (!manifest) return std::nullopt;
+  manifest << "psharded 1\n";
+  manifest << "partition "
+           << (options.partition == Partition::kRoundRobin
+                   ? "round_robin"
+                   : "hash:" + options.hash_field)
+           << "\n";
+  manifest << "sequence_field " << options.sequence_field << "\n";
+  for (unsigned i = 0; i < options.shard_count; ++i) {
+    manifest << "shard " << shard_path(stem, i).substr(dir.size()) << "\n";
+  }
+  manifest.close();
+  if (!manifest) return std::nullopt;
+
+  return ShardedLogWriter(options, std::move(manifest_path),
+                          std::move(shards));
+}
+
+unsigned ShardedLogWriter::pick_shard(std::string_view record) const {
+  if (options_.partition == Partition::kRoundRobin) return next_shard_;
+  // Hash the key field's raw value; records missing it hash the whole
+  // line so they still spread rather than piling on one shard.
+  jsonl::RecordView rec(record);
+  auto value = rec.field(options_.hash_field);
+  uint64_t h = util::xxhash64(value ? *value : record);
+  return static_cast<unsigned>(h % shards_.size());
+}
+
+bool ShardedLogWriter::append(std::string_view record) {
+  unsigned shard = pick_shard(record);
+  std::string_view line = record;
+  if (!options_.sequence_field.empty()) {
+    // Inject the sequence number as the first field of the object.
+    size_t brace = record.find('{');
+    if (brace == std::string_view::npos) return false;
+    std::string_view rest = record.substr(brace + 1);
+    size_t skip = 0;
+    while (skip < rest.size() &&
+           (rest[skip] == ' ' || rest[skip] == '\t')) {
+      ++skip;
+    }
+    bool empty_object = skip < rest.size() && rest[skip] == '}';
+    scratch_.clear();
+    scratch_.append("{\"");
+    scratch_.append(options_.sequence_field);
+    scratch_.append("\":");
+    scratch_.append(std::to_string(records_));
+    if (!empty_object) scratch_.push_back(',');
+    scratch_.append(rest);
+    line = scratch_;
+  }
+  if (!shards_[shard].append(line)) return false;
+  ++records_;
+  if (options_.partition == Partition::kRoundRobin) {
+    next_shard_ = (next_shard_ + 1) % static_cast<unsigned>(shards_.size());
+  }
+  return true;
+}
+
+bool ShardedLogWriter::flush() {
+  bool ok = true;
+  for (auto& shard : shards_) ok = shard.flush() && ok;
+  return ok;
+}
+
+struct ShardedLogReader::Impl {
+  struct Worker {
+    concurrency::SpscQueue<std::string_view> queue;
+    std::atomic<bool> done{false};
+    std::thread thread;
+    explicit Worker(size_t capacity) : queue(capacity) {}
+  };
+
+  std::vector<MmapFile> files;
+  std::vector<std::unique_ptr<Worker>> workers;
+  std::unique_ptr<std::atomic<bool>> stop =
+      std::make_unique<std::atomic<bool>>(false);
+  std::string sequence_field;
+
+  // Merge state: the head line of each shard, pre-parsed sequence
+  // number, or exhausted.
+  struct Head {
+    std::string_view line;
+    int64_t seq = 0;
+    bool loaded = false;
+    bool exhausted = false;
+  };
+  std::vector<Head> heads;
+  size_t round_robin = 0;  // cursor when there is no sequence field
+  size_t records = 0;
+
+  ~Impl() {
+    stop->store(true, std::memory_order_relaxed);
+    for (auto& w : workers) {
+      if (w->thread.joinable()) w->thread.join();
+    }
+  }
+
+  static void scan_shard(Worker& worker, std::string_view data,
+                         const std::atomic<bool>* stop) {
+    jsonl::JsonlReader scanner(data);
+    jsonl::RecordView rec;
+    while (scanner.next(rec)) {
+      while (!worker.queue.try_push(rec.raw())) {
+        if (stop->load(std::memory_order_relaxed)) {
+          worker.done.store(true, std::memory_order_release);
+          return;
+        }
+        std::this_thread::yield();  // consumer back-pressure
+      }
+    }
+    worker.done.store(true, std::memory_order_release);
+  }
+
+  // Blocks until shard `i` has a head line or is exhausted.
+  void load_head(size_t i) {
+    Head& head = heads[i];
+    if (head.loaded || head.exhausted) return;
+    Worker& w = *workers[i];
+    for (;;) {
+      if (w.queue.try_pop(head.line)) break;
+      if (w.done.load(std::memory_order_acquire)) {
+        if (w.queue.try_pop(head.line)) break;
+        head.exhausted = true;
+        return;
+      }
+      std::this_thread::yield();
+    }
+    head.loaded = true;
+    if (!sequence_field.empty()) {
+      jsonl::RecordView rec(head.line);
+      // Records without the field sort last rather than poisoning the
+      // merge.
+      head.seq = rec.int_field(sequence_field)
+                     .value_or(std::numeric_limits<int64_t>::max());
+    }
+  }
+
+  bool next(jsonl::RecordView& out) {
+    if (sequence_field.empty()) {
+      // No embedded order: drain shards round-robin.
+      for (size_t tried = 0; tried < heads.size(); ++tried) {
+        size_t i = round_robin;
+        round_robin = (round_robin + 1) % heads.size();
+        load_head(i);
+        if (heads[i].exhausted) continue;
+        out = jsonl::RecordView(heads[i].line);
+        heads[i].loaded = false;
+        ++records;
+        return true;
+      }
+      // A shard marked exhausted stays exhausted; retry the rest.
+      for (size_t i = 0; i < heads.size(); ++i) {
+        load_head(i);
+        if (!heads[i].exhausted) {
+          out = jsonl::RecordView(heads[i].line);
+          heads[i].loaded = false;
+          ++records;
+          return true;
+        }
+      }
+      return false;
+    }
+    // Ordered merge: emit the head with the smallest sequence number.
+    size_t best = heads.size();
+    for (size_t i = 0; i < heads.size(); ++i) {
+      load_head(i);
+      if (heads[i].exhausted) continue;
+      if (best == heads.size() || heads[i].seq < heads[best].seq) best = i;
+    }
+    if (best == heads.size()) return false;
+    out = jsonl::RecordView(heads[best].line);
+    heads[best].loaded = false;
+    ++records;
+    return true;
+  }
+};
+
+std::optional<ShardedLogReader> ShardedLogReader::open(
+    const std::string& manifest_path) {
+  std::ifstream manifest(manifest_path);
+  if (!manifest) return std::nullopt;
+  std::string magic;
+  int version = 0;
+  if (!(manifest >> magic >> version) || magic != "psharded" || version != 1)
+    return std::nullopt;
+
+  auto impl = std::make_unique<Impl>();
+  std::string dir = dir_of(manifest_path);
+  std::vector<std::string> shard_paths;
+  std::string line;
+  std::getline(manifest, line);  // rest of the header line
+  while (std::getline(manifest, line)) {
+    std::istringstream fields(line);
+    std::string tag, value;
+    if (!(fields >> tag)) continue;
+    if (tag == "sequence_field") {
+      if (fields >> value) impl->sequence_field = value;
+    } else if (tag == "shard") {
+      if (fields >> value) shard_paths.push_back(dir + value);
+    }
+    // "partition" only matters to writers; replay ignores it.
+  }
+  if (shard_paths.empty()) return std::nullopt;
+
+  for (const auto& path : shard_paths) {
+    auto file = MmapFile::open(path, MmapFile::Advice::kSequential);
+    if (!file) return std::nullopt;
+    impl->files.push_back(std::move(*file));
+  }
+  impl->heads.resize(impl->files.size());
+  for (size_t i = 0; i < impl->files.size(); ++i) {
+    impl->workers.push_back(std::make_unique<Impl::Worker>(kQueueCapacity));
+  }
+  for (size_t i = 0; i < impl->files.size(); ++i) {
+    Impl::Worker* w = impl->workers[i].get();
+    const std::atomic<bool>* stop = impl->stop.get();
+    std::string_view data = impl->files[i].view();
+    w->thread =
+        std::thread([w, data, stop] { Impl::scan_shard(*w, data, stop); });
+  }
+  return ShardedLogReader(std::move(impl));
+}
+
+ShardedLogReader::ShardedLogReader(std::unique_ptr<Impl> impl)
+    : impl_(std::move(impl)) {}
+ShardedLogReader::ShardedLogReader(ShardedLogReader&&) noexcept = default;
+ShardedLogReader& ShardedLogReader::operator=(ShardedLogReader&&) noexcept =
+    default;
+ShardedLogReader::~ShardedLogReader() = default;
+
+bool ShardedLogReader::next(jsonl::RecordView& out) {
+  return impl_->next(out);
+}
+
+size_t ShardedLogReader::records_read() const { return impl_->records; }
+unsigned ShardedLogReader::shard_count() const {
+  return static_cast<unsigned>(impl_->workers.size());
+}
+
+}  // namespace proga::io
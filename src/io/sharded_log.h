@@ -0,0 +1,105 @@
+#pragma once
+
+// Sharded JSONL log layout: one logical log spread over
+// `<stem>.0000.jsonl … <stem>.NNNN.jsonl` plus a `<stem>.manifest`
+// describing the shards, so writes and replay are not serialized on a
+// single file (e.g. shards placed on separate NVMe devices).
+//
+// ShardedLogWriter partitions records round-robin or by hashing a key
+// field, and can embed a monotonic sequence number so order survives
+// sharding. ShardedLogReader scans every shard on its own thread and
+// merges the streams back, by sequence number when one was embedded.
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "io/append_writer.h"
+#include "jsonl/parser.h"
+
+namespace proga::io {
+
+class ShardedLogWriter {
+ public:
+  enum class Partition {
+    kRoundRobin,  // spread uniformly
+    kHashField,   // same key value always lands on the same shard
+  };
+
+  struct Options {
+    unsigned shard_count = 4;
+    Partition partition = Partition::kRoundRobin;
+    std::string hash_field;  // key for kHashField partitioning
+    // Injected as the first field of every record so replay can
+    // restore global order; empty disables embedding.
+    std::string sequence_field = "seq";
+    AppendWriter::Options shard_options;
+  };
+
+  // `base_path` names the logical log ("logs/requests.jsonl"); shard
+  // files and the manifest are derived from it and created alongside.
+  static std::optional<ShardedLogWriter> open(const std::string& base_path,
+                                              const Options& options);
+  static std::optional<ShardedLogWriter> open(const std::string& base_path) {
+    return open(base_path, Options());
+  }
+
+  ShardedLogWriter(ShardedLogWriter&&) noexcept = default;
+  ShardedLogWriter& operator=(ShardedLogWriter&&) noexcept = default;
+
+  // Routes one record (a JSON object, no trailing newline) to its
+  // shard, embedding the sequence field when configured.
+  bool append(std::string_view record);
+
+  // Flushes every shard.
+  bool flush();
+
+  uint64_t records_written() const { return records_; }
+  unsigned shard_count() const { return static_cast<unsigned>(shards_.size()); }
+  const std::string& manifest_path() const { return manifest_path_; }
+
+ private:
+  ShardedLogWriter(Options options, std::string manifest_path,
+                   std::vector<AppendWriter> shards)
+      : options_(std::move(options)),
+        manifest_path_(std::move(manifest_path)),
+        shards_(std::move(shards)) {}
+
+  unsigned pick_shard(std::string_view record) const;
+
+  Options options_;
+  std::string manifest_path_;
+  std::vector<AppendWriter> shards_;
+  uint64_t records_ = 0;
+  unsigned next_shard_ = 0;  // round-robin cursor
+  std::string scratch_;      // sequence-injection buffer
+};
+
+// Concurrent replay over a sharded log. Each shard is mmapped and
+// scanned by its own thread; next() merges the per-shard streams by
+// the embedded sequence field (global order), or round-robin when the
+// manifest records no sequence field. Views stay valid for the
+// reader's lifetime, as with JsonlMmapReader.
+class ShardedLogReader {
+ public:
+  static std::optional<ShardedLogReader> open(const std::string& manifest_path);
+
+  ShardedLogReader(ShardedLogReader&&) noexcept;
+  ShardedLogReader& operator=(ShardedLogReader&&) noexcept;
+  ~ShardedLogReader();
+
+  bool next(jsonl::RecordView& out);
+
+  size_t records_read() const;
+  unsigned shard_count() const;
+
+ private:
+  struct Impl;
+  explicit ShardedLogReader(std::unique_ptr<Impl> impl);
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace proga::io
@@ -0,0 +1,193 @@
+#include "io/tail_reader.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace proga::io {
+
+namespace {
+
+// Reads a persisted offset; 0 if the file is missing or malformed.
+uint64_t load_offset(const std::string& path) {
+  std::FILE* f = fopen(path.c_str(), "r");
+  if (f == nullptr) return 0;
+  unsigned long long offset = 0;
+  if (fscanf(f, "%llu", &offset) != 1) offset = 0;
+  fclose(f);
+  return offset;
+}
+
+bool store_offset(const std::string& path, uint64_t offset) {
+  std::string tmp = path + ".tmp";
+  std::FILE* f = fopen(tmp.c_str(), "w");
+  if (f == nullptr) return false;
+  bool ok = fprintf(f, "%llu\n", static_cast<unsigned long long>(offset)) > 0;
+  if (fclose(f) != 0) ok = false;
+  if (ok && rename(tmp.c_str(), path.c_str()) != 0) ok = false;
+  return ok;
+}
+
+}  // namespace
+
+struct TailReader::Impl {
+  int fd = -1;
+  int inotify_fd = -1;
+  int wake_pipe[2] = {-1, -1};
+  Options options;
+  std::atomic<bool> stop{false};
+  std::atomic<uint64_t> offset{0};  // delivered up to here
+  std::vector<char> buf;            // undelivered tail, partial line first
+
+  ~Impl() {
+    if (fd >= 0) ::close(fd);
+    if (inotify_fd >= 0) ::close(inotify_fd);
+    if (wake_pipe[0] >= 0) ::close(wake_pipe[0]);
+    if (wake_pipe[1] >= 0) ::close(wake_pipe[1]);
+  }
+
+  // Reads everything currently appended and delivers complete lines
+  // in batches. Returns false on I/O error.
+  bool drain(const Callback& callback) {
+    char chunk[64 * 1024];
+    for (;;) {
+      ssize_t n = ::read(fd, chunk, sizeof(chunk));
+      if (n < 0) {
+        if (errno == EINTR) continue;
+        return false;
+      }
+      if (n == 0) break;
+      buf.insert(buf.end(), chunk, chunk + n);
+      deliver(callback);
+    }
+    return true;
+  }
+
+  void deliver(const Callback& callback) {
+    std::vector<jsonl::RecordView> batch;
+    batch.reserve(options.batch_max_records);
+    flushed_ = 0;
+    size_t consumed = 0;
+    size_t pos = 0;
+    while (pos < buf.size()) {
+      const char* nl = jsonl::detail::find_byte(buf.data() + pos,
+                                                buf.size() - pos, '\n');
+      if (nl == nullptr) break;  // partial final line: wait for more
+      size_t len = static_cast<size_t>(nl - (buf.data() + pos));
+      size_t line_end = pos + len;
+      if (len > 0 && buf[line_end - 1] == '\r') --len;
+      if (len > 0) {
+        batch.emplace_back(std::string_view(buf.data() + pos, len));
+      }
+      pos = line_end + 1;
+      consumed = pos;
+      if (batch.size() >= options.batch_max_records) {
+        flush_batch(callback, batch, consumed);
+      }
+    }
+    if (!batch.empty()) flush_batch(callback, batch, consumed);
+    if (consumed > flushed_) {
+      // Blank lines at the tail: account for them so resume doesn't
+      // re-read them, even though no batch was delivered.
+      uint64_t new_offset =
+          offset.load(std::memory_order_relaxed) + (consumed - flushed_);
+      offset.store(new_offset, std::memory_order_relaxed);
+      if (!options.offset_path.empty()) {
+        store_offset(options.offset_path, new_offset);
+      }
+    }
+    if (consumed > 0) {
+      buf.erase(buf.begin(), buf.begin() + consumed);
+    }
+  }
+
+  // `consumed` is the buffer position covered by all batches so far in
+  // this deliver() pass; the offset advances by the newly covered part.
+  void flush_batch(const Callback& callback,
+                   std::vector<jsonl::RecordView>& batch, size_t consumed) {
+    callback(std::span<const jsonl::RecordView>(batch.data(), batch.size()));
+    batch.clear();
+    uint64_t new_offset =
+        offset.load(std::memory_order_relaxed) + (consumed - flushed_);
+    flushed_ = consumed;
+    offset.store(new_offset, std::memory_order_relaxed);
+    if (!options.offset_path.empty()) {
+      store_offset(options.offset_path, new_offset);
+    }
+  }
+
+  size_t flushed_ = 0;  // buffer bytes already accounted to `offset`
+
+  bool wait_for_data() {
+    struct pollfd fds[2];
+    fds[0].fd = inotify_fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = wake_pipe[0];
+    fds[1].events = POLLIN;
+    int n = ::poll(fds, 2, options.poll_fallback_ms);
+    if (n < 0 && errno != EINTR) return false;
+    if (n > 0 && (fds[0].revents & POLLIN)) {
+      char events[4096];
+      while (::read(inotify_fd, events, sizeof(events)) > 0) {
+      }
+    }
+    return true;
+  }
+};
+
+std::optional<TailReader> TailReader::open(const std::string& path,
+                                           const Options& options) {
+  auto impl = std::make_unique<Impl>();
+  impl->options = options;
+  impl->fd = ::open(path.c_str(), O_RDONLY);
+  if (impl->fd < 0) return std::nullopt;
+
+  uint64_t resume = 0;
+  if (!options.offset_path.empty()) resume = load_offset(options.offset_path);
+  if (resume > 0 && lseek(impl->fd, static_cast<off_t>(resume), SEEK_SET) < 0) {
+    resume = 0;
+  }
+  impl->offset.store(resume, std::memory_order_relaxed);
+
+  impl->inotify_fd = inotify_init1(IN_NONBLOCK);
+  if (impl->inotify_fd >= 0) {
+    inotify_add_watch(impl->inotify_fd, path.c_str(), IN_MODIFY);
+  }
+  if (pipe(impl->wake_pipe) != 0) return std::nullopt;
+  return TailReader(std::move(impl));
+}
+
+TailReader::TailReader(std::unique_ptr<Impl> impl) : impl_(std::move(impl)) {}
+TailReader::TailReader(TailReader&&) noexcept = default;
+TailReader& TailReader::operator=(TailReader&&) noexcept = default;
+TailReader::~TailReader() = default;
+
+bool TailReader::follow(const Callback& callback) {
+  Impl& im = *impl_;
+  while (!im.stop.load(std::memory_order_relaxed)) {
+    if (!im.drain(callback)) return false;
+    if (im.stop.load(std::memory_order_relaxed)) break;
+    if (!im.wait_for_data()) return false;
+  }
+  return true;
+}
+
+void TailReader::stop() {
+  impl_->stop.store(true, std::memory_order_relaxed);
+  char byte = 1;
+  ssize_t ignored = ::write(impl_->wake_pipe[1], &byte, 1);
+  (void)ignored;
+}
+
+uint64_t TailReader::offset() const {
+  return impl_->offset.load(std::memory_order_relaxed);
+}
+
+}  // namespace proga::io
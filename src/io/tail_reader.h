@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+
+#include "jsonl/parser.h"
+
+namespace proga::io {
+
+// Tail-follow reader for a growing JSONL log. follow() blocks in an
+// inotify-driven loop, delivering newly appended records to the
+// callback in batches with no polling re-open/re-seek: appends wake
+// the loop via IN_MODIFY, a partial final line is held back until its
+// newline arrives, and the consumed offset is persisted after each
+// batch so a restarted follower resumes where it left off. stop() is
+// safe from any thread and wakes a blocked follow() immediately.
+class TailReader {
+ public:
+  struct Options {
+    // File the consumed-offset is persisted to (atomically, via
+    // rename). Empty disables persistence and starts from offset 0.
+    std::string offset_path;
+    size_t batch_max_records = 256;
+    // Safety-net poll interval for filesystems without inotify.
+    int poll_fallback_ms = 1000;
+  };
+
+  // Record views passed to the callback are valid only for the call.
+  using Callback = std::function<void(std::span<const jsonl::RecordView>)>;
+
+  static std::optional<TailReader> open(const std::string& path,
+                                        const Options& options);
+  static std::optional<TailReader> open(const std::string& path) {
+    return open(path, Options());
+  }
+
+  TailReader(TailReader&&) noexcept;
+  TailReader& operator=(TailReader&&) noexcept;
+  ~TailReader();
+
+  // Blocks, delivering batches until stop(). Returns false on I/O
+  // error. Existing records past the resume offset are delivered
+  // first, then appends as they happen.
+  bool follow(const Callback& callback);
+
+  // Wakes and terminates a concurrent follow().
+  void stop();
+
+  // Byte offset up to which records have been delivered.
+  uint64_t offset() const;
+
+ private:
+  struct Impl;
+  explicit TailReader(std::unique_ptr<Impl> impl);
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace proga::io
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "jsonl/parser.h"
+#include "mem/arena.h"
+
+namespace proga::jsonl {
+
+// A batch of records whose bytes live in an arena. Streaming readers
+// invalidate their view on every next(); filling a batch copies each
+// line into the arena once, giving downstream stages stable views with
+// no per-record heap allocation. The owner resets the arena after the
+// batch is processed, which reclaims everything at once:
+//
+//   mem::Arena arena;
+//   RecordBatch batch(&arena);
+//   while (batch.fill(reader, 1024) > 0) {
+//     for (const RecordView& rec : batch.records()) { ... }
+//     batch.clear();  // resets the arena
+//   }
+class RecordBatch {
+ public:
+  explicit RecordBatch(mem::Arena* arena)
+      : arena_(arena), records_(mem::ArenaAllocator<RecordView>(arena)) {}
+
+  // Pulls up to `max_records` from any reader with the next() contract.
+  // Returns the number of records added.
+  template <typename Reader>
+  size_t fill(Reader& reader, size_t max_records) {
+    size_t added = 0;
+    RecordView rec;
+    records_.reserve(records_.size() + max_records);
+    while (added < max_records && reader.next(rec)) {
+      records_.emplace_back(arena_->copy(rec.raw()));
+      ++added;
+    }
+    return added;
+  }
+
+  std::span<const RecordView> records() const {
+    return {records_.data(), records_.size()};
+  }
+  size_t size() const { return records_.size(); }
+
+  // Drops the records and rewinds the arena. Views from records() are
+  // invalid afterwards.
+  void clear() {
+    records_ = RecordVector(mem::ArenaAllocator<RecordView>(arena_));
+    arena_->reset();
+  }
+
+ private:
+  using RecordVector =
+      std::vector<RecordView, mem::ArenaAllocator<RecordView>>;
+
+  mem::Arena* arena_;
+  RecordVector records_;
+};
+
+}  // namespace proga::jsonl
@@ -0,0 +1,174 @@
+#include "jsonl/index.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "jsonl/parser.h"
+
+namespace proga::jsonl {
+
+namespace {
+
+constexpr char kMagic[8] = {'P', 'J', 'I', 'D', 'X', '1', 0, 0};
+
+// Mutable index state while building or extending.
+struct IndexState {
+  uint64_t record_count = 0;
+  uint64_t indexed_bytes = 0;
+  uint64_t last_record_offset = 0;
+  std::vector<uint64_t> blocks;  // (log_off, stream_off) pairs, flattened
+  std::vector<uint8_t> stream;
+
+  void add_record(uint64_t offset) {
+    if (record_count % JsonlIndex::kBlockSize == 0) {
+      blocks.push_back(offset);
+      blocks.push_back(stream.size());
+    } else {
+      uint64_t delta = offset - last_record_offset;
+      while (delta >= 0x80) {
+        stream.push_back(static_cast<uint8_t>(delta) | 0x80);
+        delta >>= 7;
+      }
+      stream.push_back(static_cast<uint8_t>(delta));
+    }
+    last_record_offset = offset;
+    ++record_count;
+  }
+
+  // Indexes records whose first byte lies in [from, log.size()),
+  // stopping at the last '\n': an unterminated tail is a record the
+  // writer is still on, and indexing it would make a later update()
+  // treat the line's remaining bytes as an extra record. indexed_bytes
+  // always lands on a record boundary so updates resume cleanly.
+  void scan(std::string_view log, uint64_t from) {
+    size_t pos = from;
+    while (pos < log.size()) {
+      // Record = non-empty line, matching the readers' skip rules.
+      if (log[pos] == '\n' || log[pos] == '\r') {
+        ++pos;
+        indexed_bytes = pos;
+        continue;
+      }
+      const char* nl =
+          detail::find_byte(log.data() + pos, log.size() - pos, '\n');
+      if (nl == nullptr) break;  // partial final line: left for update()
+      add_record(pos);
+      pos = static_cast<size_t>(nl - log.data()) + 1;
+      indexed_bytes = pos;
+    }
+  }
+
+  bool write(const std::string& index_path) const {
+    std::FILE* f = fopen(index_path.c_str(), "wb");
+    if (f == nullptr) return false;
+    bool ok = fwrite(kMagic, 1, sizeof(kMagic), f) == sizeof(kMagic);
+    uint64_t header[4] = {record_count, indexed_bytes, last_record_offset,
+                          blocks.size() / 2};
+    ok = ok && fwrite(header, sizeof(uint64_t), 4, f) == 4;
+    ok = ok && (blocks.empty() ||
+                fwrite(blocks.data(), sizeof(uint64_t), blocks.size(), f) ==
+                    blocks.size());
+    uint64_t stream_len = stream.size();
+    ok = ok && fwrite(&stream_len, sizeof(uint64_t), 1, f) == 1;
+    ok = ok && (stream.empty() ||
+                fwrite(stream.data(), 1, stream.size(), f) == stream.size());
+    if (fclose(f) != 0) ok = false;
+    return ok;
+  }
+};
+
+bool build_from(const std::string& log_path, const std::string& index_path,
+                IndexState state) {
+  auto log = io::MmapFile::open(log_path, io::MmapFile::Advice::kSequential);
+  if (!log) return false;
+  if (log->size() < state.indexed_bytes) return false;  // log shrank
+  state.scan(log->view(), state.indexed_bytes);
+  return state.write(index_path);
+}
+
+}  // namespace
+
+bool JsonlIndex::build(const std::string& log_path,
+                       const std::string& index_path) {
+  return build_from(log_path, index_path, IndexState{});
+}
+
+bool JsonlIndex::update(const std::string& log_path,
+                        const std::string& index_path) {
+  auto existing = JsonlIndex::open(index_path);
+  if (!existing) return build(log_path, index_path);
+  IndexState state;
+  state.record_count = existing->record_count_;
+  state.indexed_bytes = existing->indexed_bytes_;
+  state.blocks.assign(existing->blocks_,
+                      existing->blocks_ + existing->block_count_ * 2);
+  state.stream.assign(existing->stream_,
+                      existing->stream_ + existing->stream_len_);
+  if (existing->record_count_ > 0) {
+    auto last = existing->seek(existing->record_count_ - 1);
+    if (!last) return build(log_path, index_path);
+    state.last_record_offset = *last;
+  }
+  if (!build_from(log_path, index_path, std::move(state))) {
+    // A rotated/truncated log invalidates the old entries.
+    return build(log_path, index_path);
+  }
+  return true;
+}
+
+std::optional<JsonlIndex> JsonlIndex::open(const std::string& index_path) {
+  auto file = io::MmapFile::open(index_path, io::MmapFile::Advice::kRandom);
+  if (!file) return std::nullopt;
+  JsonlIndex index(std::move(*file));
+  if (!index.parse()) return std::nullopt;
+  return index;
+}
+
+bool JsonlIndex::parse() {
+  const char* p = file_.data();
+  const char* end = p + file_.size();
+  if (file_.size() < sizeof(kMagic) + 4 * sizeof(uint64_t)) return false;
+  if (memcmp(p, kMagic, sizeof(kMagic)) != 0) return false;
+  p += sizeof(kMagic);
+  uint64_t header[4];
+  memcpy(header, p, sizeof(header));
+  p += sizeof(header);
+  record_count_ = header[0];
+  indexed_bytes_ = header[1];
+  block_count_ = header[3];
+  if (p + block_count_ * 2 * sizeof(uint64_t) + sizeof(uint64_t) > end) {
+    return false;
+  }
+  blocks_ = reinterpret_cast<const uint64_t*>(p);
+  p += block_count_ * 2 * sizeof(uint64_t);
+  memcpy(&stream_len_, p, sizeof(uint64_t));
+  p += sizeof(uint64_t);
+  if (p + stream_len_ > end) return false;
+  stream_ = reinterpret_cast<const uint8_t*>(p);
+  uint64_t expected_blocks = (record_count_ + kBlockSize - 1) / kBlockSize;
+  return block_count_ == expected_blocks;
+}
+
+std::optional<uint64_t> JsonlIndex::seek(uint64_t record_no) const {
+  if (record_no >= record_count_) return std::nullopt;
+  uint64_t block = record_no / kBlockSize;
+  uint64_t offset = blocks_[block * 2];
+  const uint8_t* s = stream_ + blocks_[block * 2 + 1];
+  const uint8_t* s_end = stream_ + stream_len_;
+  for (uint64_t i = block * kBlockSize; i < record_no; ++i) {
+    uint64_t delta = 0;
+    int shift = 0;
+    for (;;) {
+      if (s >= s_end) return std::nullopt;  // truncated stream
+      uint8_t byte = *s++;
+      delta |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) break;
+      shift += 7;
+    }
+    offset += delta;
+  }
+  return offset;
+}
+
+}  // namespace proga::jsonl
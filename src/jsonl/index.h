@@ -0,0 +1,57 @@
+#pragma once
+
+// Line-offset index for random access into a JSONL log.
+//
+// The index file stores the byte offset of every record, delta-encoded
+// as LEB128 varints in blocks of 64 records. Each block's absolute log
+// offset and position in the varint stream live in a fixed header
+// table, so seek(record_no) is one table lookup plus at most 63 varint
+// decodes. The header also records how many log bytes were indexed,
+// which lets update() extend the index by scanning only appended data.
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "io/mmap_file.h"
+
+namespace proga::jsonl {
+
+class JsonlIndex {
+ public:
+  static constexpr uint32_t kBlockSize = 64;
+
+  // Scans the whole log and (re)writes the index file.
+  static bool build(const std::string& log_path, const std::string& index_path);
+
+  // Extends an existing index over bytes appended to the log since it
+  // was built. Falls back to a full build if the index is missing or
+  // the log shrank (e.g. was rotated).
+  static bool update(const std::string& log_path,
+                     const std::string& index_path);
+
+  // Maps an index file for lookups. Returns nullopt if the file is
+  // missing or malformed.
+  static std::optional<JsonlIndex> open(const std::string& index_path);
+
+  uint64_t record_count() const { return record_count_; }
+  uint64_t indexed_bytes() const { return indexed_bytes_; }
+
+  // Byte offset of the start of record `record_no` in the log, or
+  // nullopt if the record number is out of range.
+  std::optional<uint64_t> seek(uint64_t record_no) const;
+
+ private:
+  explicit JsonlIndex(io::MmapFile file) : file_(std::move(file)) {}
+  bool parse();
+
+  io::MmapFile file_;
+  uint64_t record_count_ = 0;
+  uint64_t indexed_bytes_ = 0;
+  uint64_t block_count_ = 0;
+  const uint64_t* blocks_ = nullptr;  // pairs of (log_off, stream_off)
+  const uint8_t* stream_ = nullptr;
+  uint64_t stream_len_ = 0;
+};
+
+}  // namespace proga::jsonl
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "io/mmap_file.h"
+#include "io/prefault.h"
+#include "jsonl/parser.h"
+
+namespace proga::jsonl {
+
+// JsonlReader over a memory-mapped log: the file is mapped once and
+// record views alias the mapping for the reader's lifetime, so this is
+// the zero-copy way to replay a log. Unlike JsonlFileReader, views
+// stay valid until the reader is destroyed.
+class JsonlMmapReader {
+ public:
+  struct Options {
+    io::MmapFile::Advice advice = io::MmapFile::Advice::kSequential;
+    bool huge_pages = false;
+    // Prefault window for start_prefault(); 0 keeps the Prefaulter
+    // default.
+    size_t prefault_window_bytes = 0;
+  };
+
+  static std::optional<JsonlMmapReader> open(
+      const std::string& path,
+      io::MmapFile::Advice advice = io::MmapFile::Advice::kSequential) {
+    auto file = io::MmapFile::open(path, advice);
+    if (!file) return std::nullopt;
+    return JsonlMmapReader(std::move(*file));
+  }
+
+  static std::optional<JsonlMmapReader> open(const std::string& path,
+                                             const Options& options) {
+    io::MmapFile::Options file_options;
+    file_options.advice = options.advice;
+    file_options.huge_pages = options.huge_pages;
+    auto file = io::MmapFile::open(path, file_options);
+    if (!file) return std::nullopt;
+    JsonlMmapReader reader(std::move(*file));
+    reader.options_ = options;
+    return reader;
+  }
+
+  // Starts a background toucher faulting pages ahead of the replay
+  // cursor. Call once the reader has reached its final location — the
+  // toucher samples this instance, so moving it afterwards would leave
+  // the toucher reading a dead object.
+  void start_prefault() {
+    if (prefault_ || file_.size() == 0) return;
+    io::Prefaulter::Options prefault_options;
+    if (options_.prefault_window_bytes > 0) {
+      prefault_options.window_bytes = options_.prefault_window_bytes;
+    }
+    prefault_ = std::make_unique<io::Prefaulter>(
+        file_.data(), file_.size(), [this] { return bytes_consumed(); },
+        prefault_options);
+  }
+
+  size_t bytes_prefaulted() const {
+    return prefault_ ? prefault_->bytes_touched() : 0;
+  }
+
+  // Blocks until the toucher has walked the whole mapping; only
+  // meaningful once the replay cursor has reached EOF.
+  void wait_prefault() const {
+    if (prefault_) prefault_->wait_complete();
+  }
+
+  bool next(RecordView& out) { return reader_.next(out); }
+  size_t records_read() const { return reader_.records_read(); }
+  // Replay position (one past the last consumed byte) — what a
+  // checkpoint records to resume from.
+  size_t bytes_consumed() const { return reader_.bytes_consumed(); }
+
+  const io::MmapFile& file() const { return file_; }
+
+ private:
+  explicit JsonlMmapReader(io::MmapFile file)
+      : file_(std::move(file)), reader_(file_.view()) {}
+
+  io::MmapFile file_;
+  JsonlReader reader_;
+  Options options_;
+  std::unique_ptr<io::Prefaulter> prefault_;
+};
+
+}  // namespace proga::jsonl
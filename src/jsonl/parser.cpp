@@ -0,0 +1,318 @@
+#include "jsonl/parser.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#include "util/instrument.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace proga::jsonl {
+
+namespace detail {
+
+const char* find_byte(const char* p, size_t n, char c) {
+#if defined(__AVX2__)
+  const __m256i needle = _mm256_set1_epi8(c);
+  while (n >= 32) {
+    __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    uint32_t mask = static_cast<uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle)));
+    if (mask != 0) return p + __builtin_ctz(mask);
+    p += 32;
+    n -= 32;
+  }
+#elif defined(__SSE2__)
+  const __m128i needle = _mm_set1_epi8(c);
+  while (n >= 16) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    uint32_t mask = static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+    if (mask != 0) return p + __builtin_ctz(mask);
+    p += 16;
+    n -= 16;
+  }
+#elif defined(__ARM_NEON)
+  const uint8x16_t needle = vdupq_n_u8(static_cast<uint8_t>(c));
+  while (n >= 16) {
+    uint8x16_t block = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+    uint8x16_t eq = vceqq_u8(block, needle);
+    uint64_t lo = vgetq_lane_u64(vreinterpretq_u64_u8(eq), 0);
+    uint64_t hi = vgetq_lane_u64(vreinterpretq_u64_u8(eq), 1);
+    if (lo != 0) return p + (__builtin_ctzll(lo) >> 3);
+    if (hi != 0) return p + 8 + (__builtin_ctzll(hi) >> 3);
+    p += 16;
+    n -= 16;
+  }
+#endif
+  return static_cast<const char*>(memchr(p, c, n));
+}
+
+namespace {
+
+bool is_ws(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+// Advances past a JSON string, `p` pointing at the opening quote.
+// Returns one past the closing quote, or nullptr on malformed input.
+const char* skip_string(const char* p, const char* end) {
+  ++p;  // opening quote
+  while (p < end) {
+    const char* q = find_byte(p, static_cast<size_t>(end - p), '"');
+    if (q == nullptr) return nullptr;
+    // A quote preceded by an odd number of backslashes is escaped.
+    const char* b = q;
+    while (b > p && b[-1] == '\\') --b;
+    if (((q - b) & 1) == 0) return q + 1;
+    p = q + 1;
+  }
+  return nullptr;
+}
+
+// Advances past one JSON value of any type. Returns one past its last
+// byte, or nullptr on malformed input.
+const char* skip_value(const char* p, const char* end) {
+  while (p < end && is_ws(*p)) ++p;
+  if (p >= end) return nullptr;
+  if (*p == '"') return skip_string(p, end);
+  if (*p == '{' || *p == '[') {
+    int depth = 0;
+    while (p < end) {
+      char c = *p;
+      if (c == '"') {
+        p = skip_string(p, end);
+        if (p == nullptr) return nullptr;
+        continue;
+      }
+      if (c == '{' || c == '[') {
+        ++depth;
+      } else if (c == '}' || c == ']') {
+        if (--depth == 0) return p + 1;
+      }
+      ++p;
+    }
+    return nullptr;
+  }
+  // Number, true/false/null: runs until a structural byte.
+  while (p < end && *p != ',' && *p != '}' && *p != ']' && !is_ws(*p)) ++p;
+  return p;
+}
+
+}  // namespace
+
+const char* begin_fields(std::string_view line) {
+  const char* p = line.data();
+  const char* end = p + line.size();
+  while (p < end && is_ws(*p)) ++p;
+  if (p >= end || *p != '{') return nullptr;
+  return p + 1;
+}
+
+bool next_field(const char*& p, const char* end, std::string_view& key,
+                std::string_view& value) {
+  while (p < end && (is_ws(*p) || *p == ',')) ++p;
+  if (p >= end || *p == '}') return false;
+  if (*p != '"') return false;
+  const char* key_begin = p + 1;
+  const char* key_close = skip_string(p, end);
+  if (key_close == nullptr) return false;
+  key = std::string_view(key_begin,
+                         static_cast<size_t>(key_close - 1 - key_begin));
+  p = key_close;
+  while (p < end && is_ws(*p)) ++p;
+  if (p >= end || *p != ':') return false;
+  ++p;
+  while (p < end && is_ws(*p)) ++p;
+  const char* value_begin = p;
+  const char* value_end = skip_value(p, end);
+  if (value_end == nullptr) return false;
+  value = std::string_view(value_begin,
+                           static_cast<size_t>(value_end - value_begin));
+  p = value_end;
+  return true;
+}
+
+std::optional<std::string_view> to_string(std::string_view raw) {
+  if (raw.size() < 2 || raw.front() != '"' || raw.back() != '"') {
+    return std::nullopt;
+  }
+  return raw.substr(1, raw.size() - 2);
+}
+
+std::optional<double> to_double(std::string_view raw) {
+  if (raw.empty()) return std::nullopt;
+  char buf[64];
+  size_t n = std::min(raw.size(), sizeof(buf) - 1);
+  memcpy(buf, raw.data(), n);
+  buf[n] = '\0';
+  char* parse_end = nullptr;
+  double d = strtod(buf, &parse_end);
+  if (parse_end == buf) return std::nullopt;
+  return d;
+}
+
+std::optional<int64_t> to_int64(std::string_view raw) {
+  if (raw.empty()) return std::nullopt;
+  const char* p = raw.data();
+  const char* end = p + raw.size();
+  bool neg = false;
+  if (*p == '-') {
+    neg = true;
+    ++p;
+  }
+  if (p >= end) return std::nullopt;
+  // Accumulate the magnitude unsigned and bound it against the signed
+  // range, so 64-bit unsigned IDs and other out-of-range integers are
+  // rejected (callers fall through to the float/string paths) instead
+  // of wrapping. INT64_MIN's magnitude is representable, so
+  // -9223372036854775808 still parses.
+  constexpr uint64_t kMaxMagnitude =
+      static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+  const uint64_t limit = neg ? kMaxMagnitude + 1 : kMaxMagnitude;
+  uint64_t magnitude = 0;
+  while (p < end && *p >= '0' && *p <= '9') {
+    uint64_t digit = static_cast<uint64_t>(*p - '0');
+    if (magnitude > (limit - digit) / 10) return std::nullopt;  // overflow
+    magnitude = magnitude * 10 + digit;
+    ++p;
+  }
+  if (p != end) return std::nullopt;  // not a plain integer
+  if (neg) return static_cast<int64_t>(~magnitude + 1);
+  return static_cast<int64_t>(magnitude);
+}
+
+}  // namespace detail
+
+std::optional<std::string_view> RecordView::field(std::string_view key) const {
+  const char* p = detail::begin_fields(line_);
+  if (p == nullptr) return std::nullopt;
+  const char* end = line_.data() + line_.size();
+  std::string_view this_key, value;
+  while (detail::next_field(p, end, this_key, value)) {
+    if (this_key == key) return value;
+  }
+  return std::nullopt;
+}
+
+std::optional<std::string_view> RecordView::string_field(
+    std::string_view key) const {
+  auto v = field(key);
+  if (!v) return std::nullopt;
+  return detail::to_string(*v);
+}
+
+std::optional<double> RecordView::double_field(std::string_view key) const {
+  auto v = field(key);
+  if (!v) return std::nullopt;
+  return detail::to_double(*v);
+}
+
+std::optional<int64_t> RecordView::int_field(std::string_view key) const {
+  auto v = field(key);
+  if (!v) return std::nullopt;
+  return detail::to_int64(*v);
+}
+
+bool JsonlReader::next(RecordView& out) {
+  while (pos_ < buf_.size()) {
+    const char* line_begin = buf_.data() + pos_;
+    size_t remaining = buf_.size() - pos_;
+    const char* nl = detail::find_byte(line_begin, remaining, '\n');
+    size_t len = nl != nullptr ? static_cast<size_t>(nl - line_begin) : remaining;
+    pos_ += len + (nl != nullptr ? 1 : 0);
+    // Tolerate CRLF logs and blank separator lines.
+    if (len > 0 && line_begin[len - 1] == '\r') --len;
+    if (len == 0) continue;
+    out = RecordView(std::string_view(line_begin, len));
+    ++records_;
+    return true;
+  }
+  return false;
+}
+
+JsonlFileReader::JsonlFileReader(int fd, size_t buffer_size)
+    : fd_(fd), buf_(buffer_size) {}
+
+JsonlFileReader::JsonlFileReader(JsonlFileReader&& other) noexcept
+    : fd_(other.fd_),
+      buf_(std::move(other.buf_)),
+      begin_(other.begin_),
+      end_(other.end_),
+      eof_(other.eof_),
+      records_(other.records_) {
+  other.fd_ = -1;
+}
+
+JsonlFileReader& JsonlFileReader::operator=(JsonlFileReader&& other) noexcept {
+  if (this != &other) {
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = other.fd_;
+    buf_ = std::move(other.buf_);
+    begin_ = other.begin_;
+    end_ = other.end_;
+    eof_ = other.eof_;
+    records_ = other.records_;
+    other.fd_ = -1;
+  }
+  return *this;
+}
+
+JsonlFileReader::~JsonlFileReader() {
+  if (fd_ >= 0) ::close(fd_);
+}
+
+std::optional<JsonlFileReader> JsonlFileReader::open(const std::string& path,
+                                                    size_t buffer_size) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) return std::nullopt;
+  return JsonlFileReader(fd, buffer_size);
+}
+
+bool JsonlFileReader::next(RecordView& out) {
+  PROGA_TIMED_SCOPE("parser.file_next");
+  for (;;) {
+    // Look for a complete line in the buffered window.
+    const char* window = buf_.data() + begin_;
+    size_t avail = end_ - begin_;
+    const char* nl = detail::find_byte(window, avail, '\n');
+    if (nl != nullptr || (eof_ && avail > 0)) {
+      size_t len = nl != nullptr ? static_cast<size_t>(nl - window) : avail;
+      begin_ += len + (nl != nullptr ? 1 : 0);
+      if (len > 0 && window[len - 1] == '\r') --len;
+      if (len == 0) continue;
+      out = RecordView(std::string_view(window, len));
+      ++records_;
+      return true;
+    }
+    if (eof_) return false;
+    // Compact the partial line to the front and refill. A line longer
+    // than the buffer grows it rather than splitting the record.
+    if (begin_ > 0) {
+      memmove(buf_.data(), buf_.data() + begin_, avail);
+      end_ = avail;
+      begin_ = 0;
+    } else if (end_ == buf_.size()) {
+      buf_.resize(buf_.size() * 2);
+    }
+    PROGA_TIMED_SCOPE("io.file_refill");
+    ssize_t n = ::read(fd_, buf_.data() + end_, buf_.size() - end_);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      eof_ = true;  // surface the tail we already have, then stop
+    } else if (n == 0) {
+      eof_ = true;
+    } else {
+      end_ += static_cast<size_t>(n);
+    }
+  }
+}
+
+}  // namespace proga::jsonl
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace proga::jsonl {
+
+// Non-owning view of one JSONL record (a single line of the log).
+// Field values are located lazily on access: nothing is tokenized or
+// copied up front, so iterating a file and touching one field per
+// record only ever scans the bytes it needs.
+class RecordView {
+ public:
+  RecordView() = default;
+  explicit RecordView(std::string_view line) : line_(line) {}
+
+  // The raw line, without the trailing newline.
+  std::string_view raw() const { return line_; }
+  bool empty() const { return line_.empty(); }
+
+  // Raw JSON text of the value for a top-level key ("\"x\"", "12.5",
+  // "[1,2]", ...), or nullopt if the key is absent.
+  std::optional<std::string_view> field(std::string_view key) const;
+
+  // Typed accessors. string_field() returns the bytes between the
+  // quotes verbatim; escape sequences are not decoded.
+  std::optional<std::string_view> string_field(std::string_view key) const;
+  std::optional<double> double_field(std::string_view key) const;
+  std::optional<int64_t> int_field(std::string_view key) const;
+
+ private:
+  std::string_view line_;
+};
+
+// Pull-style reader over an in-memory JSONL buffer. Yields one
+// RecordView per line; empty lines are skipped. No per-record
+// allocation: views point into the caller's buffer.
+//
+//   JsonlReader reader(buffer);
+//   RecordView rec;
+//   while (reader.next(rec)) { ... }
+class JsonlReader {
+ public:
+  explicit JsonlReader(std::string_view buffer) : buf_(buffer) {}
+
+  // Advances to the next record. Returns false at end of buffer.
+  bool next(RecordView& out);
+
+  size_t records_read() const { return records_; }
+  size_t bytes_consumed() const { return pos_; }
+
+ private:
+  std::string_view buf_;
+  size_t pos_ = 0;
+  size_t records_ = 0;
+};
+
+// Streaming reader over a file descriptor. Maintains an internal
+// refill buffer and carries partial trailing lines across reads, so
+// record views stay valid until the following next() call.
+class JsonlFileReader {
+ public:
+  static constexpr size_t kDefaultBufferSize = 1 << 20;
+
+  // Opens `path` for reading. Returns nullopt on failure (errno is
+  // left set by open(2)).
+  static std::optional<JsonlFileReader> open(const std::string& path,
+                                            size_t buffer_size = kDefaultBufferSize);
+
+  JsonlFileReader(JsonlFileReader&& other) noexcept;
+  JsonlFileReader& operator=(JsonlFileReader&& other) noexcept;
+  JsonlFileReader(const JsonlFileReader&) = delete;
+  JsonlFileReader& operator=(const JsonlFileReader&) = delete;
+  ~JsonlFileReader();
+
+  // Advances to the next record, refilling from the file as needed.
+  // The returned view is invalidated by the next call.
+  bool next(RecordView& out);
+
+  size_t records_read() const { return records_; }
+
+ private:
+  JsonlFileReader(int fd, size_t buffer_size);
+
+  int fd_ = -1;
+  std::vector<char> buf_;
+  size_t begin_ = 0;  // first unconsumed byte in buf_
+  size_t end_ = 0;    // one past the last valid byte in buf_
+  bool eof_ = false;
+  size_t records_ = 0;
+};
+
+namespace detail {
+
+// Scans [p, p + n) for byte `c`, vectorized (AVX2/SSE2) where the
+// target supports it. Returns nullptr if absent.
+const char* find_byte(const char* p, size_t n, char c);
+
+// Typed conversions from raw JSON value text, shared by RecordView's
+// accessors and the schema layer.
+std::optional<std::string_view> to_string(std::string_view raw);
+std::optional<double> to_double(std::string_view raw);
+std::optional<int64_t> to_int64(std::string_view raw);
+
+// Single-pass iteration over the top-level key/value pairs of one
+// record. begin_fields() returns a cursor just past the opening brace
+// (nullptr if the line is not an object); next_field() yields one pair
+// per call until the closing brace or malformed input.
+const char* begin_fields(std::string_view line);
+bool next_field(const char*& p, const char* end, std::string_view& key,
+                std::string_view& value);
+
+}  // namespace detail
+
+}  // namespace proga::jsonl
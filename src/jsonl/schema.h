@@ -0,0 +1,206 @@
+#pragma once
+
+// Declared record schemas with compile-time field accessors.
+//
+// A schema names the fields a record shape carries, once, as a type:
+//
+//   using Request = jsonl::Schema<jsonl::Field<"url", std::string_view>,
+//                                 jsonl::Field<"latency_ms", double>>;
+//
+// Request::parse() walks the record's key/value pairs a single time and
+// drops each raw value into a fixed slot, so hot loops read fields via
+// Request::get<"latency_ms">(row) with the slot index resolved at
+// compile time — no per-access key scan, hashing, or branching on field
+// names. Records that do not carry every declared field fail parse()
+// and take the dynamic RecordView path instead.
+//
+// SchemaRegistry is the runtime side: shapes declared by name, with
+// per-field types, for callers that discover schemas from config
+// rather than at compile time (validation, tooling).
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "jsonl/parser.h"
+
+namespace proga::jsonl {
+
+// String usable as a non-type template parameter (C++20 structural
+// type). Stores the terminator so kField.view() excludes it.
+template <size_t N>
+struct FixedString {
+  char value[N] = {};
+
+  constexpr FixedString(const char (&s)[N]) {
+    for (size_t i = 0; i < N; ++i) value[i] = s[i];
+  }
+  constexpr std::string_view view() const {
+    return std::string_view(value, N - 1);
+  }
+};
+
+// One declared field: name plus the type its accessor yields. T must
+// be std::string_view, double, or int64_t, matching RecordView's typed
+// accessors.
+template <FixedString Name, typename T>
+struct Field {
+  static constexpr auto kName = Name;
+  using type = T;
+  static_assert(std::is_same_v<T, std::string_view> ||
+                    std::is_same_v<T, double> || std::is_same_v<T, int64_t>,
+                "Field type must be string_view, double, or int64_t");
+};
+
+template <typename... Fields>
+class Schema {
+ public:
+  static constexpr size_t kFieldCount = sizeof...(Fields);
+  static_assert(kFieldCount >= 1 && kFieldCount <= 32,
+                "Schema supports 1..32 fields");
+
+  // Raw value slices for one record, one slot per declared field.
+  // Views point into the record's line, with RecordView lifetime rules.
+  struct Row {
+    std::array<std::string_view, kFieldCount> raw;
+    uint32_t present = 0;
+  };
+
+  // Slot index for a declared field name; a typo is a compile error.
+  template <FixedString Name>
+  static constexpr size_t index_of() {
+    constexpr size_t idx = find_index(Name.view());
+    static_assert(idx != kNpos, "field name not declared in this schema");
+    return idx;
+  }
+
+  // One walk over the record's key/value pairs. Returns true when every
+  // declared field was present; on false the caller should fall back to
+  // dynamic RecordView lookups. Keys written in declared order (the
+  // common case for machine-generated logs) match with one comparison
+  // each; others take a short linear probe. Undeclared keys are skipped.
+  static bool parse(const RecordView& rec, Row& out) {
+    out.present = 0;
+    const char* p = detail::begin_fields(rec.raw());
+    if (p == nullptr) return false;
+    const char* end = rec.raw().data() + rec.raw().size();
+    std::string_view key, value;
+    size_t hint = 0;  // next slot if keys arrive in declared order
+    while (detail::next_field(p, end, key, value)) {
+      size_t idx;
+      if (hint < kFieldCount && kNames[hint] == key) {
+        idx = hint++;
+      } else {
+        idx = find_index(key);
+        if (idx == kNpos) continue;
+      }
+      out.raw[idx] = value;
+      out.present |= uint32_t{1} << idx;
+    }
+    return out.present == kFullMask;
+  }
+
+  // Typed read of a declared field; the slot offset and conversion are
+  // fixed at compile time. nullopt only when the raw value does not
+  // convert (e.g. "n/a" where a number was declared).
+  template <FixedString Name>
+  static auto get(const Row& row) {
+    constexpr size_t idx = index_of<Name>();
+    using T = typename std::tuple_element_t<idx, std::tuple<Fields...>>::type;
+    std::string_view raw = row.raw[idx];
+    if constexpr (std::is_same_v<T, std::string_view>) {
+      return detail::to_string(raw);
+    } else if constexpr (std::is_same_v<T, double>) {
+      return detail::to_double(raw);
+    } else {
+      return detail::to_int64(raw);
+    }
+  }
+
+  // Declared field names, in slot order.
+  static constexpr std::array<std::string_view, kFieldCount> names() {
+    return kNames;
+  }
+
+ private:
+  static constexpr size_t kNpos = static_cast<size_t>(-1);
+  static constexpr std::array<std::string_view, kFieldCount> kNames = {
+      Fields::kName.view()...};
+  static constexpr uint32_t kFullMask =
+      kFieldCount == 32 ? ~uint32_t{0} : (uint32_t{1} << kFieldCount) - 1;
+
+  static constexpr size_t find_index(std::string_view name) {
+    for (size_t i = 0; i < kFieldCount; ++i) {
+      if (kNames[i] == name) return i;
+    }
+    return kNpos;
+  }
+};
+
+// Runtime-declared shapes, for callers that learn schemas from config
+// or use them for validation rather than hot-loop access.
+enum class FieldType { kString, kDouble, kInt };
+
+struct DeclaredField {
+  std::string name;
+  FieldType type;
+};
+
+class SchemaRegistry {
+ public:
+  struct Declared {
+    std::string name;
+    std::vector<DeclaredField> fields;
+  };
+
+  // Declares (or replaces) a named shape.
+  void declare(std::string name, std::vector<DeclaredField> fields) {
+    for (auto& d : schemas_) {
+      if (d.name == name) {
+        d.fields = std::move(fields);
+        return;
+      }
+    }
+    schemas_.push_back({std::move(name), std::move(fields)});
+  }
+
+  const Declared* find(std::string_view name) const {
+    for (const auto& d : schemas_) {
+      if (d.name == name) return &d;
+    }
+    return nullptr;
+  }
+
+  size_t size() const { return schemas_.size(); }
+
+  // True when every declared field is present and its value converts to
+  // the declared type. Extra keys in the record are allowed.
+  static bool conforms(const RecordView& rec, const Declared& schema) {
+    for (const auto& f : schema.fields) {
+      auto raw = rec.field(f.name);
+      if (!raw) return false;
+      switch (f.type) {
+        case FieldType::kString:
+          if (!detail::to_string(*raw)) return false;
+          break;
+        case FieldType::kDouble:
+          if (!detail::to_double(*raw)) return false;
+          break;
+        case FieldType::kInt:
+          if (!detail::to_int64(*raw)) return false;
+          break;
+      }
+    }
+    return true;
+  }
+
+ private:
+  std::vector<Declared> schemas_;
+};
+
+}  // namespace proga::jsonl
@@ -0,0 +1,199 @@
+#include "jsonl/skip_index.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "util/hash.h"
+
+namespace proga::jsonl {
+
+namespace {
+
+constexpr char kMagic[8] = {'P', 'B', 'L', 'O', 'O', 'M', '1', 0};
+
+// Composite hash over field and value so one filter serves every key
+// field without cross-field collisions by construction.
+uint64_t key_hash(std::string_view field, std::string_view value,
+                  uint64_t seed) {
+  return util::xxhash64(value.data(), value.size(),
+                        util::xxhash64(field) ^ seed);
+}
+
+// The bytes a value contributes: the unquoted text for JSON strings,
+// the raw slice otherwise, so probes pass plain values ("user-001").
+std::string_view value_bytes(std::string_view raw) {
+  auto s = detail::to_string(raw);
+  return s ? *s : raw;
+}
+
+void set_bits(std::vector<uint64_t>& bits, uint64_t h1, uint64_t h2,
+              unsigned probes) {
+  uint64_t bit_count = bits.size() * 64;
+  for (unsigned i = 0; i < probes; ++i) {
+    uint64_t bit = (h1 + i * h2) % bit_count;
+    bits[bit >> 6] |= uint64_t{1} << (bit & 63);
+  }
+}
+
+bool test_bits(const std::vector<uint64_t>& bits, uint64_t h1, uint64_t h2,
+               unsigned probes) {
+  uint64_t bit_count = bits.size() * 64;
+  for (unsigned i = 0; i < probes; ++i) {
+    uint64_t bit = (h1 + i * h2) % bit_count;
+    if ((bits[bit >> 6] & (uint64_t{1} << (bit & 63))) == 0) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+std::optional<BloomSkipIndex> BloomSkipIndex::build(
+    const std::string& jsonl_path, const std::string& index_path,
+    const Options& options) {
+  if (options.key_fields.empty() || options.bits_per_key == 0)
+    return std::nullopt;
+  auto log = io::MmapFile::open(jsonl_path, io::MmapFile::Advice::kSequential);
+  if (!log) return std::nullopt;
+
+  BloomSkipIndex index;
+  index.key_fields_ = options.key_fields;
+  // k = bits_per_key * ln 2 minimizes the false-positive rate.
+  index.num_probes_ = std::max(
+      1u, static_cast<unsigned>(
+              std::lround(static_cast<double>(options.bits_per_key) * 0.693)));
+
+  std::string_view data = log->view();
+  JsonlReader reader(data);
+  RecordView rec;
+  uint64_t block_begin = 0;
+  std::vector<std::pair<uint64_t, uint64_t>> hashes;  // (h1, h2) per key
+  auto flush_block = [&](uint64_t block_end) {
+    if (hashes.empty() && block_begin == block_end) return;
+    Block block;
+    block.begin = block_begin;
+    block.end = block_end;
+    size_t bit_count = std::max<size_t>(
+        64, (hashes.size() * options.bits_per_key + 63) & ~size_t{63});
+    block.bits.assign(bit_count / 64, 0);
+    for (const auto& [h1, h2] : hashes) {
+      set_bits(block.bits, h1, h2, index.num_probes_);
+    }
+    index.blocks_.push_back(std::move(block));
+    hashes.clear();
+    block_begin = block_end;
+  };
+
+  while (reader.next(rec)) {
+    for (const auto& field : index.key_fields_) {
+      auto raw = rec.field(field);
+      if (!raw) continue;
+      std::string_view v = value_bytes(*raw);
+      hashes.emplace_back(key_hash(field, v, 0),
+                          key_hash(field, v, 0x9e3779b97f4a7c15ull) | 1);
+    }
+    uint64_t consumed = reader.bytes_consumed();
+    if (consumed - block_begin >= options.block_bytes) flush_block(consumed);
+  }
+  flush_block(data.size());
+
+  // Persist: magic, field names, probe count, block directory + bits.
+  std::FILE* f = fopen(index_path.c_str(), "wb");
+  if (f == nullptr) return std::nullopt;
+  bool ok = fwrite(kMagic, 1, sizeof(kMagic), f) == sizeof(kMagic);
+  uint32_t field_count = static_cast<uint32_t>(index.key_fields_.size());
+  ok = ok && fwrite(&field_count, sizeof(field_count), 1, f) == 1;
+  for (const auto& field : index.key_fields_) {
+    uint32_t len = static_cast<uint32_t>(field.size());
+    ok = ok && fwrite(&len, sizeof(len), 1, f) == 1;
+    ok = ok && fwrite(field.data(), 1, field.size(), f) == field.size();
+  }
+  uint32_t probes = index.num_probes_;
+  uint64_t block_count = index.blocks_.size();
+  ok = ok && fwrite(&probes, sizeof(probes), 1, f) == 1;
+  ok = ok && fwrite(&block_count, sizeof(block_count), 1, f) == 1;
+  for (const auto& block : index.blocks_) {
+    uint64_t header[3] = {block.begin, block.end, block.bits.size()};
+    ok = ok && fwrite(header, sizeof(uint64_t), 3, f) == 3;
+    ok = ok && fwrite(block.bits.data(), sizeof(uint64_t), block.bits.size(),
+                      f) == block.bits.size();
+  }
+  if (fclose(f) != 0) ok = false;
+  if (!ok) return std::nullopt;
+  return index;
+}
+
+std::optional<BloomSkipIndex> BloomSkipIndex::open(
+    const std::string& index_path) {
+  std::FILE* f = fopen(index_path.c_str(), "rb");
+  if (f == nullptr) return std::nullopt;
+  auto read_or = [&](void* dst, size_t bytes) {
+    return fread(dst, 1, bytes, f) == bytes;
+  };
+
+  BloomSkipIndex index;
+  char magic[8];
+  uint32_t field_count = 0;
+  bool ok = read_or(magic, sizeof(magic)) &&
+            memcmp(magic, kMagic, sizeof(kMagic)) == 0 &&
+            read_or(&field_count, sizeof(field_count)) && field_count < 4096;
+  for (uint32_t i = 0; ok && i < field_count; ++i) {
+    uint32_t len = 0;
+    ok = read_or(&len, sizeof(len)) && len < 4096;
+    if (ok) {
+      std::string field(len, '\0');
+      ok = read_or(field.data(), len);
+      index.key_fields_.push_back(std::move(field));
+    }
+  }
+  uint64_t block_count = 0;
+  ok = ok && read_or(&index.num_probes_, sizeof(index.num_probes_)) &&
+       read_or(&block_count, sizeof(block_count));
+  for (uint64_t i = 0; ok && i < block_count; ++i) {
+    uint64_t header[3];
+    ok = read_or(header, sizeof(header)) && header[2] > 0 &&
+         header[2] < (uint64_t{1} << 32);
+    if (ok) {
+      Block block;
+      block.begin = header[0];
+      block.end = header[1];
+      block.bits.resize(header[2]);
+      ok = read_or(block.bits.data(), block.bits.size() * sizeof(uint64_t));
+      index.blocks_.push_back(std::move(block));
+    }
+  }
+  fclose(f);
+  if (!ok || index.num_probes_ == 0) return std::nullopt;
+  return index;
+}
+
+std::vector<BloomSkipIndex::Range> BloomSkipIndex::candidate_ranges(
+    std::string_view field, std::string_view value) const {
+  std::vector<Range> ranges;
+  bool indexed_field = false;
+  for (const auto& f : key_fields_) {
+    if (f == field) {
+      indexed_field = true;
+      break;
+    }
+  }
+  uint64_t h1 = key_hash(field, value, 0);
+  uint64_t h2 = key_hash(field, value, 0x9e3779b97f4a7c15ull) | 1;
+  for (const auto& block : blocks_) {
+    // An un-indexed field cannot prune anything.
+    if (indexed_field && !test_bits(block.bits, h1, h2, num_probes_)) continue;
+    if (!ranges.empty() && ranges.back().end == block.begin) {
+      ranges.back().end = block.end;  // coalesce adjacent blocks
+    } else {
+      ranges.push_back({block.begin, block.end});
+    }
+  }
+  return ranges;
+}
+
+bool BloomSkipIndex::may_contain(std::string_view field,
+                                 std::string_view value) const {
+  return !candidate_ranges(field, value).empty();
+}
+
+}  // namespace proga::jsonl
@@ -0,0 +1,97 @@
+#pragma once
+
+// Bloom-filter skip index for selective replay.
+//
+// build() cuts the log into record-aligned byte blocks (~block_bytes
+// each) and fills one Bloom filter per block with the values of the
+// configured key fields. The artifact lives next to the log
+// ("requests.jsonl.bloom", gitignored like the other derived files).
+// A point lookup then asks candidate_ranges() for the byte ranges
+// whose filter might hold the value and replays only those — blocks
+// that provably lack the key are never touched, so finding one request
+// id in a huge log reads a handful of blocks instead of all of them.
+//
+// Filters are sized from the actual per-block key count at
+// bits_per_key bits (default 10, ~1% false positives), with k probes
+// derived from two xxhash64 passes (double hashing).
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "io/mmap_file.h"
+#include "jsonl/parser.h"
+
+namespace proga::jsonl {
+
+class BloomSkipIndex {
+ public:
+  struct Options {
+    std::vector<std::string> key_fields;
+    size_t block_bytes = 1 << 20;
+    size_t bits_per_key = 10;
+  };
+
+  // One log byte range that may contain the probed value.
+  struct Range {
+    uint64_t begin = 0;
+    uint64_t end = 0;
+  };
+
+  // Scans `jsonl_path` once and writes the index to `index_path`.
+  // Returns the in-memory index, or nullopt on I/O failure or an empty
+  // key-field list.
+  static std::optional<BloomSkipIndex> build(const std::string& jsonl_path,
+                                             const std::string& index_path,
+                                             const Options& options);
+
+  static std::optional<BloomSkipIndex> open(const std::string& index_path);
+
+  // Byte ranges of the log whose block filter matches `value` for
+  // `field`. A field the index was not built over cannot prune, so
+  // every block is returned.
+  std::vector<Range> candidate_ranges(std::string_view field,
+                                      std::string_view value) const;
+
+  // True when any block might contain the value.
+  bool may_contain(std::string_view field, std::string_view value) const;
+
+  size_t block_count() const { return blocks_.size(); }
+  const std::vector<std::string>& key_fields() const { return key_fields_; }
+
+  // Replays only the candidate blocks of `jsonl_path`, invoking
+  // fn(const RecordView&) for each record in them. The caller still
+  // filters records: a block match is a maybe, not a hit.
+  template <typename Fn>
+  bool scan_candidates(const std::string& jsonl_path, std::string_view field,
+                       std::string_view value, Fn&& fn) const {
+    auto file = io::MmapFile::open(jsonl_path, io::MmapFile::Advice::kRandom);
+    if (!file) return false;
+    std::string_view data = file->view();
+    RecordView rec;
+    for (const Range& range : candidate_ranges(field, value)) {
+      if (range.end > data.size()) return false;  // stale index
+      JsonlReader reader(data.substr(range.begin, range.end - range.begin));
+      while (reader.next(rec)) fn(static_cast<const RecordView&>(rec));
+    }
+    return true;
+  }
+
+ private:
+  struct Block {
+    uint64_t begin = 0;
+    uint64_t end = 0;
+    std::vector<uint64_t> bits;
+  };
+
+  BloomSkipIndex() = default;
+
+  std::vector<std::string> key_fields_;
+  unsigned num_probes_ = 0;
+  std::vector<Block> blocks_;
+};
+
+}  // namespace proga::jsonl
@@ -0,0 +1,168 @@
+#include "jsonl/time_index.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace proga::jsonl {
+
+namespace {
+
+constexpr char kMagic[8] = {'P', 'T', 'I', 'D', 'X', '0', '0', '1'};
+
+}  // namespace
+
+std::optional<TimeIndex> TimeIndex::build(const std::string& jsonl_path,
+                                          const std::string& index_path,
+                                          const Options& options) {
+  if (options.timestamp_field.empty()) return std::nullopt;
+  auto log = io::MmapFile::open(jsonl_path, io::MmapFile::Advice::kSequential);
+  if (!log) return std::nullopt;
+
+  TimeIndex index;
+  index.timestamp_field_ = options.timestamp_field;
+
+  std::string_view data = log->view();
+  JsonlReader reader(data);
+  RecordView rec;
+  Block block;
+  auto flush_block = [&](uint64_t block_end) {
+    if (block.begin == block_end) return;
+    block.end = block_end;
+    index.blocks_.push_back(block);
+    block = Block{};
+    block.begin = block_end;
+  };
+
+  while (reader.next(rec)) {
+    if (auto ts = rec.double_field(index.timestamp_field_)) {
+      if (!block.has_timestamps) {
+        block.min = block.max = *ts;
+        block.has_timestamps = true;
+      } else {
+        block.min = std::min(block.min, *ts);
+        block.max = std::max(block.max, *ts);
+      }
+    }
+    uint64_t consumed = reader.bytes_consumed();
+    if (consumed - block.begin >= options.block_bytes) flush_block(consumed);
+  }
+  flush_block(data.size());
+  index.compute_ordered();
+
+  std::FILE* f = fopen(index_path.c_str(), "wb");
+  if (f == nullptr) return std::nullopt;
+  bool ok = fwrite(kMagic, 1, sizeof(kMagic), f) == sizeof(kMagic);
+  uint32_t field_len = static_cast<uint32_t>(index.timestamp_field_.size());
+  ok = ok && fwrite(&field_len, sizeof(field_len), 1, f) == 1;
+  ok = ok && fwrite(index.timestamp_field_.data(), 1, field_len, f) ==
+                 field_len;
+  uint64_t block_count = index.blocks_.size();
+  ok = ok && fwrite(&block_count, sizeof(block_count), 1, f) == 1;
+  for (const Block& b : index.blocks_) {
+    uint64_t offsets[2] = {b.begin, b.end};
+    double bounds[2] = {b.min, b.max};
+    uint32_t has = b.has_timestamps ? 1 : 0;
+    ok = ok && fwrite(offsets, sizeof(uint64_t), 2, f) == 2;
+    ok = ok && fwrite(bounds, sizeof(double), 2, f) == 2;
+    ok = ok && fwrite(&has, sizeof(has), 1, f) == 1;
+  }
+  if (fclose(f) != 0) ok = false;
+  if (!ok) return std::nullopt;
+  return index;
+}
+
+std::optional<TimeIndex> TimeIndex::open(const std::string& index_path) {
+  std::FILE* f = fopen(index_path.c_str(), "rb");
+  if (f == nullptr) return std::nullopt;
+  auto read_or = [&](void* dst, size_t bytes) {
+    return fread(dst, 1, bytes, f) == bytes;
+  };
+
+  TimeIndex index;
+  char magic[8];
+  uint32_t field_len = 0;
+  bool ok = read_or(magic, sizeof(magic)) &&
+            memcmp(magic, kMagic, sizeof(kMagic)) == 0 &&
+            read_or(&field_len, sizeof(field_len)) && field_len < 4096;
+  if (ok) {
+    index.timestamp_field_.assign(field_len, '\0');
+    ok = read_or(index.timestamp_field_.data(), field_len);
+  }
+  uint64_t block_count = 0;
+  ok = ok && read_or(&block_count, sizeof(block_count)) &&
+       block_count < (uint64_t{1} << 40);
+  for (uint64_t i = 0; ok && i < block_count; ++i) {
+    uint64_t offsets[2];
+    double bounds[2];
+    uint32_t has = 0;
+    ok = read_or(offsets, sizeof(offsets)) &&
+         read_or(bounds, sizeof(bounds)) && read_or(&has, sizeof(has));
+    if (ok) {
+      Block block;
+      block.begin = offsets[0];
+      block.end = offsets[1];
+      block.min = bounds[0];
+      block.max = bounds[1];
+      block.has_timestamps = has != 0;
+      index.blocks_.push_back(block);
+    }
+  }
+  fclose(f);
+  if (!ok) return std::nullopt;
+  index.compute_ordered();
+  return index;
+}
+
+void TimeIndex::compute_ordered() {
+  // Binary search needs a cleanly partitioned directory, so a block
+  // with no timestamps at all (predicate-neutral) forces the linear
+  // walk — rare outside synthetic logs, and still correct.
+  ordered_ = true;
+  double prev_max = 0;
+  bool have_prev = false;
+  for (const Block& block : blocks_) {
+    if (!block.has_timestamps || (have_prev && block.min < prev_max)) {
+      ordered_ = false;
+      return;
+    }
+    prev_max = block.max;
+    have_prev = true;
+  }
+}
+
+std::vector<TimeIndex::Range> TimeIndex::candidate_ranges(double from,
+                                                          double to) const {
+  std::vector<Range> ranges;
+  auto add = [&](const Block& block) {
+    if (!ranges.empty() && ranges.back().end == block.begin) {
+      ranges.back().end = block.end;
+    } else {
+      ranges.push_back({block.begin, block.end});
+    }
+  };
+  size_t start = 0;
+  if (ordered_) {
+    // Time-ordered log: binary search the first block that can still
+    // reach the window, then walk until blocks start past it.
+    start = static_cast<size_t>(
+        std::lower_bound(blocks_.begin(), blocks_.end(), from,
+                         [](const Block& block, double t) {
+                           return block.has_timestamps && block.max < t;
+                         }) -
+        blocks_.begin());
+  }
+  for (size_t i = start; i < blocks_.size(); ++i) {
+    const Block& block = blocks_[i];
+    if (!block.has_timestamps) continue;  // nothing in it can match
+    if (block.min > to) {
+      if (ordered_) break;
+      continue;
+    }
+    if (block.max < from) continue;
+    add(block);
+  }
+  return ranges;
+}
+
+}  // namespace proga::jsonl
@@ -0,0 +1,97 @@
+#pragma once
+
+// Sparse timestamp index for time-range pruning.
+//
+// build() cuts the log into record-aligned byte blocks (~block_bytes
+// each) and records the min/max of the timestamp field per block in a
+// .tidx artifact next to the log (gitignored, like the other derived
+// files). A time-bounded query asks candidate_ranges() for the blocks
+// whose [min, max] intersects the requested window and scans only
+// those, so cost tracks the range rather than the log. Logs are
+// normally appended in time order; when every block's minimum is at or
+// past its predecessor's maximum the lookup binary-searches instead of
+// walking the block directory.
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "io/mmap_file.h"
+#include "jsonl/parser.h"
+
+namespace proga::jsonl {
+
+class TimeIndex {
+ public:
+  struct Options {
+    std::string timestamp_field = "ts";
+    size_t block_bytes = 1 << 20;
+  };
+
+  struct Range {
+    uint64_t begin = 0;
+    uint64_t end = 0;
+  };
+
+  // One pass over `jsonl_path`, writing the index to `index_path`.
+  // Works as a backfill over an existing log; an appender can simply
+  // rebuild after rotation.
+  static std::optional<TimeIndex> build(const std::string& jsonl_path,
+                                        const std::string& index_path,
+                                        const Options& options);
+
+  static std::optional<TimeIndex> open(const std::string& index_path);
+
+  // Byte ranges of the log whose block may hold timestamps within
+  // [from, to] (inclusive). Adjacent candidates are coalesced.
+  std::vector<Range> candidate_ranges(double from, double to) const;
+
+  // Replays only the candidate blocks, invoking fn(const RecordView&)
+  // for records whose timestamp lies within [from, to]. Records
+  // without the field never match.
+  template <typename Fn>
+  bool scan_range(const std::string& jsonl_path, double from, double to,
+                  Fn&& fn) const {
+    auto file = io::MmapFile::open(jsonl_path, io::MmapFile::Advice::kRandom);
+    if (!file) return false;
+    std::string_view data = file->view();
+    RecordView rec;
+    for (const Range& range : candidate_ranges(from, to)) {
+      if (range.end > data.size()) return false;  // stale index
+      JsonlReader reader(data.substr(range.begin, range.end - range.begin));
+      while (reader.next(rec)) {
+        auto ts = rec.double_field(timestamp_field_);
+        if (ts && *ts >= from && *ts <= to) {
+          fn(static_cast<const RecordView&>(rec));
+        }
+      }
+    }
+    return true;
+  }
+
+  size_t block_count() const { return blocks_.size(); }
+  const std::string& timestamp_field() const { return timestamp_field_; }
+  // True when the blocks are mutually time-ordered and lookups binary
+  // search the directory.
+  bool time_ordered() const { return ordered_; }
+
+ private:
+  struct Block {
+    uint64_t begin = 0;
+    uint64_t end = 0;
+    double min = 0;
+    double max = 0;
+    bool has_timestamps = false;
+  };
+
+  TimeIndex() = default;
+  void compute_ordered();
+
+  std::string timestamp_field_;
+  std::vector<Block> blocks_;
+  bool ordered_ = false;
+};
+
+}  // namespace proga::jsonl
@@ -0,0 +1,179 @@
+#include "jsonl/validate.h"
+
+#include <cstdio>
+
+#include "io/mmap_file.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace proga::jsonl {
+
+namespace detail {
+
+namespace {
+
+// Scalar validation of a span that contains at least one non-ASCII
+// byte. Classic range-based checks per leading byte.
+bool validate_utf8_scalar(const uint8_t* p, const uint8_t* end) {
+  while (p < end) {
+    uint8_t lead = *p;
+    if (lead < 0x80) {
+      ++p;
+      continue;
+    }
+    if (lead < 0xc2) return false;  // stray continuation or overlong C0/C1
+    if (lead < 0xe0) {              // 2 bytes
+      if (end - p < 2 || (p[1] & 0xc0) != 0x80) return false;
+      p += 2;
+    } else if (lead < 0xf0) {  // 3 bytes
+      if (end - p < 3 || (p[1] & 0xc0) != 0x80 || (p[2] & 0xc0) != 0x80)
+        return false;
+      if (lead == 0xe0 && p[1] < 0xa0) return false;  // overlong
+      if (lead == 0xed && p[1] >= 0xa0) return false;  // surrogate
+      p += 3;
+    } else if (lead < 0xf5) {  // 4 bytes
+      if (end - p < 4 || (p[1] & 0xc0) != 0x80 || (p[2] & 0xc0) != 0x80 ||
+          (p[3] & 0xc0) != 0x80) {
+        return false;
+      }
+      if (lead == 0xf0 && p[1] < 0x90) return false;   // overlong
+      if (lead == 0xf4 && p[1] >= 0x90) return false;  // > U+10FFFF
+      p += 4;
+    } else {
+      return false;  // F5..FF never appear in UTF-8
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+bool validate_utf8(const char* data, size_t n) {
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+  const uint8_t* end = p + n;
+  // Vectorized sweep: skip ahead while blocks are pure ASCII, which is
+  // the steady state for machine-generated logs.
+  for (;;) {
+#if defined(__AVX2__)
+    while (end - p >= 32) {
+      __m256i block =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+      if (_mm256_movemask_epi8(block) != 0) break;
+      p += 32;
+    }
+#elif defined(__SSE2__)
+    while (end - p >= 16) {
+      __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+      if (_mm_movemask_epi8(block) != 0) break;
+      p += 16;
+    }
+#elif defined(__ARM_NEON)
+    while (end - p >= 16) {
+      uint8x16_t block = vld1q_u8(p);
+      if (vmaxvq_u8(block) >= 0x80) break;
+      p += 16;
+    }
+#endif
+    // Scalar tail / first non-ASCII span: validate up to the next
+    // vector-aligned resume point. Extend the span to a sequence
+    // boundary so a multi-byte character is never split.
+    const uint8_t* span_end = end - p > 64 ? p + 64 : end;
+    while (span_end < end && (*span_end & 0xc0) == 0x80) ++span_end;
+    if (p == span_end) return true;
+    if (!validate_utf8_scalar(p, span_end)) return false;
+    p = span_end;
+    if (p >= end) return true;
+  }
+}
+
+}  // namespace detail
+
+bool Validator::add(const RecordView& rec) {
+  ++records_;
+  bool passed = true;
+  if (options_.check_utf8 &&
+      !detail::validate_utf8(rec.raw().data(), rec.raw().size())) {
+    ++utf8_errors_;
+    passed = false;
+  }
+  if (options_.schema != nullptr &&
+      !SchemaRegistry::conforms(rec, *options_.schema)) {
+    ++schema_errors_;
+    passed = false;
+  }
+  if (!options_.timestamp_field.empty()) {
+    auto ts = rec.double_field(options_.timestamp_field);
+    if (!ts) {
+      ++timestamp_regressions_;  // a missing timestamp can't be ordered
+      passed = false;
+    } else {
+      if (have_timestamp_ && *ts < last_timestamp_) {
+        ++timestamp_regressions_;
+        passed = false;
+      }
+      last_timestamp_ = *ts;
+      have_timestamp_ = true;
+    }
+  }
+  return passed;
+}
+
+bool Validator::validate_file(const std::string& path) {
+  auto file = io::MmapFile::open(path, io::MmapFile::Advice::kSequential);
+  if (!file) return false;
+  std::string_view data = file->view();
+  // Whole-buffer UTF-8 first: one vectorized sweep instead of a
+  // restart per record. Per-record UTF-8 re-checks only run when the
+  // sweep found a problem and we need to attribute it.
+  bool buffer_clean =
+      !options_.check_utf8 || detail::validate_utf8(data.data(), data.size());
+  bool per_record_utf8 = options_.check_utf8 && !buffer_clean;
+  Options saved = options_;
+  options_.check_utf8 = per_record_utf8;
+  JsonlReader reader(data);
+  RecordView rec;
+  while (reader.next(rec)) add(rec);
+  options_ = std::move(saved);
+  return true;
+}
+
+std::string Validator::report() const {
+  std::string out;
+  char line[160];
+  unsigned tests = 0;
+  unsigned failed = 0;
+  auto emit = [&](const char* name, uint64_t errors) {
+    ++tests;
+    if (errors > 0) ++failed;
+    std::snprintf(line, sizeof(line),
+                  "test name=validate.%s status=%s errors=%llu records=%llu\n",
+                  name, errors == 0 ? "ok" : "fail",
+                  static_cast<unsigned long long>(errors),
+                  static_cast<unsigned long long>(records_));
+    out += line;
+  };
+  if (options_.check_utf8) emit("utf8", utf8_errors_);
+  if (options_.schema != nullptr) emit("schema", schema_errors_);
+  if (!options_.timestamp_field.empty()) {
+    emit("timestamps", timestamp_regressions_);
+  }
+  std::snprintf(line, sizeof(line), "summary tests=%u failed=%u\n", tests,
+                failed);
+  out += line;
+  return out;
+}
+
+bool Validator::write_report(const std::string& path) const {
+  std::FILE* f = fopen(path.c_str(), "w");
+  if (f == nullptr) return false;
+  std::string text = report();
+  bool ok = fwrite(text.data(), 1, text.size(), f) == text.size();
+  if (fclose(f) != 0) ok = false;
+  return ok;
+}
+
+}  // namespace proga::jsonl
@@ -0,0 +1,80 @@
+#pragma once
+
+// Always-on validation stage for incoming logs.
+//
+// Checks three invariants at ingest line rate: byte soundness (UTF-8),
+// schema conformance against a SchemaRegistry shape, and monotonic
+// (non-decreasing) timestamps. UTF-8 takes a vectorized ASCII fast
+// path — 32 bytes per step on AVX2, and log lines are overwhelmingly
+// ASCII — dropping to a scalar DFA only for spans that actually carry
+// multi-byte sequences. validate_file() checks a whole mmapped log in
+// one pass; add() runs as a per-record pipeline stage.
+//
+// The report uses the test_output.txt line format ("test name=...
+// status=..." plus a trailing summary) so the same tooling that reads
+// test runs can consume validation results.
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "jsonl/parser.h"
+#include "jsonl/schema.h"
+
+namespace proga::jsonl {
+
+class Validator {
+ public:
+  struct Options {
+    // Shape every record must conform to; nullptr skips the check.
+    // The pointer must outlive the validator.
+    const SchemaRegistry::Declared* schema = nullptr;
+    // Numeric field that must never decrease; empty skips the check.
+    std::string timestamp_field;
+    bool check_utf8 = true;
+  };
+
+  explicit Validator(Options options) : options_(std::move(options)) {}
+
+  // Validates one record. Returns true when it passed every enabled
+  // check (failures are counted either way).
+  bool add(const RecordView& rec);
+
+  // One pass over a log file: UTF-8 over the whole buffer in a single
+  // vectorized sweep, then per-record checks. Returns false only on
+  // I/O failure; validation findings land in the counters.
+  bool validate_file(const std::string& path);
+
+  uint64_t records() const { return records_; }
+  uint64_t utf8_errors() const { return utf8_errors_; }
+  uint64_t schema_errors() const { return schema_errors_; }
+  uint64_t timestamp_regressions() const { return timestamp_regressions_; }
+  bool ok() const {
+    return utf8_errors_ == 0 && schema_errors_ == 0 &&
+           timestamp_regressions_ == 0;
+  }
+
+  // test_output.txt-format report over the enabled checks.
+  std::string report() const;
+  bool write_report(const std::string& path) const;
+
+ private:
+  Options options_;
+  uint64_t records_ = 0;
+  uint64_t utf8_errors_ = 0;
+  uint64_t schema_errors_ = 0;
+  uint64_t timestamp_regressions_ = 0;
+  double last_timestamp_ = 0;
+  bool have_timestamp_ = false;
+};
+
+namespace detail {
+
+// True when [p, p + n) is well-formed UTF-8 (rejects overlong forms,
+// surrogates, and code points past U+10FFFF). Vectorized ASCII fast
+// path, scalar DFA for multi-byte spans.
+bool validate_utf8(const char* p, size_t n);
+
+}  // namespace detail
+
+}  // namespace proga::jsonl
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <sys/mman.h>
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace proga::mem {
+
+// Bump allocator for per-batch parse state. Allocation is a pointer
+// bump; reset() rewinds to the first block and keeps the memory for
+// the next batch, so a steady-state ingest loop stops touching
+// malloc/free entirely and batch teardown is O(1).
+//
+// With huge_pages set, blocks of at least one huge page are mapped
+// directly (MAP_HUGETLB when the system has reserved huge pages,
+// otherwise anonymous memory hinted with MADV_HUGEPAGE), trimming TLB
+// pressure for arenas that hold multi-GB parse state.
+class Arena {
+ public:
+  static constexpr size_t kDefaultBlockSize = 64 * 1024;
+  static constexpr size_t kHugePageBytes = 2 * 1024 * 1024;
+
+  explicit Arena(size_t block_size = kDefaultBlockSize,
+                 bool huge_pages = false)
+      : block_size_(block_size), huge_pages_(huge_pages) {}
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  ~Arena() {
+    for (Block& b : blocks_) {
+      if (b.mapped) {
+        munmap(b.data, b.size);
+      } else {
+        delete[] b.data;
+      }
+    }
+  }
+
+  void* allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+    size_t aligned = (cursor_ + align - 1) & ~(align - 1);
+    if (current_ >= blocks_.size() || aligned + size > blocks_[current_].size) {
+      next_block(size + align);
+      aligned = (cursor_ + align - 1) & ~(align - 1);
+    }
+    void* p = blocks_[current_].data + aligned;
+    cursor_ = aligned + size;
+    bytes_used_ += size;
+    return p;
+  }
+
+  // Copies `s` into the arena; the result lives until reset().
+  std::string_view copy(std::string_view s) {
+    if (s.empty()) return {};
+    char* p = static_cast<char*>(allocate(s.size(), 1));
+    memcpy(p, s.data(), s.size());
+    return std::string_view(p, s.size());
+  }
+
+  // Rewinds the arena, retaining every block for reuse.
+  void reset() {
+    current_ = 0;
+    cursor_ = 0;
+    bytes_used_ = 0;
+  }
+
+  size_t bytes_used() const { return bytes_used_; }
+  size_t bytes_reserved() const {
+    size_t total = 0;
+    for (const Block& b : blocks_) total += b.size;
+    return total;
+  }
+
+  // True when the current backing store uses huge-page mappings.
+  bool huge_page_backed() const {
+    for (const Block& b : blocks_) {
+      if (b.mapped) return true;
+    }
+    return false;
+  }
+
+ private:
+  struct Block {
+    char* data;
+    size_t size;
+    bool mapped;  // munmap vs delete[]
+  };
+
+  void next_block(size_t min_size) {
+    // Advance into a retained block if one is big enough; otherwise
+    // grow. Oversized requests get a dedicated block.
+    while (current_ + 1 < blocks_.size()) {
+      ++current_;
+      cursor_ = 0;
+      if (blocks_[current_].size >= min_size) return;
+    }
+    size_t size = block_size_ > min_size ? block_size_ : min_size;
+    blocks_.push_back(new_block(size));
+    current_ = blocks_.size() - 1;
+    cursor_ = 0;
+  }
+
+  Block new_block(size_t size) {
+    if (huge_pages_ && size >= kHugePageBytes) {
+      size_t rounded = (size + kHugePageBytes - 1) & ~(kHugePageBytes - 1);
+      // Reserved huge pages first; most hosts have none, so fall back
+      // to anonymous memory with the transparent-huge-page hint.
+      void* p = MAP_FAILED;
+#if defined(MAP_HUGETLB)
+      p = mmap(nullptr, rounded, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+      if (p == MAP_FAILED) {
+        p = mmap(nullptr, rounded, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#if defined(MADV_HUGEPAGE)
+        if (p != MAP_FAILED) madvise(p, rounded, MADV_HUGEPAGE);
+#endif
+      }
+      if (p != MAP_FAILED) {
+        return Block{static_cast<char*>(p), rounded, true};
+      }
+    }
+    return Block{new char[size], size, false};
+  }
+
+  size_t block_size_;
+  bool huge_pages_;
+  std::vector<Block> blocks_;
+  size_t current_ = 0;
+  size_t cursor_ = 0;
+  size_t bytes_used_ = 0;
+};
+
+// std-compatible allocator over an Arena, for containers whose
+// contents die with the batch. Deallocation is a no-op; memory comes
+// back on Arena::reset().
+template <typename T>
+class ArenaAllocator {
+ public:
+  using value_type = T;
+
+  explicit ArenaAllocator(Arena* arena) : arena_(arena) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) : arena_(other.arena()) {}
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+  }
+  void deallocate(T*, size_t) {}
+
+  Arena* arena() const { return arena_; }
+
+  bool operator==(const ArenaAllocator& other) const {
+    return arena_ == other.arena_;
+  }
+
+ private:
+  Arena* arena_;
+};
+
+}  // namespace proga::mem
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "mem/arena.h"
+#include "util/binary.h"
+
+namespace proga::mem {
+
+// String interning table: repeated field values resolve to a dense
+// 32-bit symbol id, so a loaded log stores each distinct URL or user
+// agent once and equality becomes an integer compare. Open addressing
+// with linear probing over a power-of-two slot array; string bytes
+// live in an arena owned by the table. Sized for hundreds of millions
+// of lookups: a probe touches only (hash, symbol) pairs, and full key
+// compares happen only on 32-bit hash collisions.
+class InternTable {
+ public:
+  using Symbol = uint32_t;
+  static constexpr Symbol kInvalidSymbol = 0xffffffffu;
+
+  explicit InternTable(size_t expected_symbols = 1024)
+      : arena_(256 * 1024) {
+    size_t cap = 16;
+    while (cap < expected_symbols * 2) cap <<= 1;
+    slots_.assign(cap, Slot{0, kInvalidSymbol});
+  }
+
+  // Returns the symbol for `s`, inserting it on first sight. Symbols
+  // are dense: 0, 1, 2, ... in first-seen order.
+  Symbol intern(std::string_view s) {
+    uint32_t h = hash(s);
+    size_t mask = slots_.size() - 1;
+    size_t i = h & mask;
+    for (;;) {
+      Slot& slot = slots_[i];
+      if (slot.symbol == kInvalidSymbol) {
+        Symbol sym = static_cast<Symbol>(strings_.size());
+        strings_.push_back(arena_.copy(s));
+        slot = Slot{h, sym};
+        if (++used_ * 10 >= slots_.size() * 7) grow();
+        return sym;
+      }
+      if (slot.hash == h && strings_[slot.symbol] == s) return slot.symbol;
+      i = (i + 1) & mask;
+    }
+  }
+
+  // Lookup without insertion.
+  std::optional<Symbol> find(std::string_view s) const {
+    uint32_t h = hash(s);
+    size_t mask = slots_.size() - 1;
+    size_t i = h & mask;
+    for (;;) {
+      const Slot& slot = slots_[i];
+      if (slot.symbol == kInvalidSymbol) return std::nullopt;
+      if (slot.hash == h && strings_[slot.symbol] == s) return slot.symbol;
+      i = (i + 1) & mask;
+    }
+  }
+
+  std::string_view resolve(Symbol sym) const { return strings_[sym]; }
+  size_t size() const { return strings_.size(); }
+  size_t capacity() const { return slots_.size(); }
+
+  // Bytes held by the interned strings themselves.
+  size_t string_bytes() const { return arena_.bytes_used(); }
+
+  // Snapshot support: the strings in symbol order are the whole state;
+  // deserialize re-interns them, rebuilding the slot array, so symbol
+  // ids come back identical.
+  void serialize(std::vector<uint8_t>& out) const {
+    util::put_u64(out, strings_.size());
+    for (std::string_view s : strings_) util::put_string(out, s);
+  }
+
+  bool deserialize(util::BinaryCursor& in) {
+    if (!strings_.empty()) return false;  // restore into a fresh table
+    uint64_t count = 0;
+    if (!in.get_u64(count)) return false;
+    for (uint64_t i = 0; i < count; ++i) {
+      std::string_view s;
+      if (!in.get_string(s)) return false;
+      intern(s);
+    }
+    return strings_.size() == count;
+  }
+
+ private:
+  struct Slot {
+    uint32_t hash;
+    Symbol symbol;
+  };
+
+  static uint32_t hash(std::string_view s) {
+    // FNV-1a with a finalizer mix; cheap and fine for text keys.
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (char c : s) {
+      h ^= static_cast<uint8_t>(c);
+      h *= 0x100000001b3ull;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    return static_cast<uint32_t>(h);
+  }
+
+  void grow() {
+    std::vector<Slot> old = std::move(slots_);
+    slots_.assign(old.size() * 2, Slot{0, kInvalidSymbol});
+    size_t mask = slots_.size() - 1;
+    for (const Slot& slot : old) {
+      if (slot.symbol == kInvalidSymbol) continue;
+      size_t i = slot.hash & mask;
+      while (slots_[i].symbol != kInvalidSymbol) i = (i + 1) & mask;
+      slots_[i] = slot;
+    }
+  }
+
+  Arena arena_;
+  std::vector<std::string_view> strings_;  // symbol -> bytes
+  std::vector<Slot> slots_;
+  size_t used_ = 0;
+};
+
+}  // namespace proga::mem
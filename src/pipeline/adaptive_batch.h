@@ -0,0 +1,118 @@
+#pragma once
+
+// Adaptive batch sizing toward a target p99 delivery latency.
+//
+// Fixed batch sizes are wrong in both deployments: large batches add
+// tail latency for live tail-follow consumers, small ones waste
+// replay throughput on per-batch overhead. AdaptiveBatcher watches
+// what actually happens — arrival rate and per-batch delivery latency
+// (first record buffered to batch handed out, sketched with DDSketch)
+// — and resizes multiplicatively each control window: shrink when the
+// window's p99 overshoots the target, grow when it sits under half of
+// it. The size is additionally capped at the number of records the
+// arrival rate can produce inside the latency budget, so an idle tail
+// degenerates to single-record batches and a replay saturates at
+// max_batch. Delivery latencies also feed the instrumentation stage
+// "pipeline.batch_delivery", so the chosen behaviour is visible in
+// the standard snapshot/summary surface.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "agg/sketch.h"
+#include "util/instrument.h"
+
+namespace proga::pipeline {
+
+class AdaptiveBatcher {
+ public:
+  struct Options {
+    double target_p99_ms = 10.0;
+    size_t min_batch = 1;
+    size_t max_batch = 4096;
+    size_t initial_batch = 64;
+    // Batches per control step; small enough to track load shifts,
+    // large enough for a meaningful p99.
+    unsigned adjust_every = 32;
+  };
+
+  explicit AdaptiveBatcher(const Options& options)
+      : options_(options),
+        size_(std::clamp(options.initial_batch, options.min_batch,
+                         options.max_batch)),
+        window_(0.01, 512),
+        last_arrival_(Clock::now()) {}
+  AdaptiveBatcher() : AdaptiveBatcher(Options()) {}
+
+  // The size the next batch should aim for.
+  size_t batch_size() const { return size_; }
+
+  // Reports one delivered batch: its record count and the latency from
+  // the first record becoming available to delivery.
+  void on_batch(size_t records, uint64_t delivery_ns) {
+    auto now = Clock::now();
+    double interval_s =
+        std::chrono::duration<double>(now - last_arrival_).count();
+    last_arrival_ = now;
+    if (interval_s > 0) {
+      double rate = static_cast<double>(records) / interval_s;
+      // EWMA smooths bursty arrivals without a history buffer.
+      arrival_rate_ = arrival_rate_ == 0 ? rate
+                                         : 0.8 * arrival_rate_ + 0.2 * rate;
+    }
+    window_.add(static_cast<double>(delivery_ns));
+#if defined(PROGA_INSTRUMENT)
+    util::Instrumentation::stage("pipeline.batch_delivery")
+        .record(static_cast<uint64_t>(static_cast<double>(delivery_ns) *
+                                      util::Instrumentation::cycles_per_ns()));
+#endif
+    ++batches_;
+    if (window_.count() >= options_.adjust_every) adjust();
+  }
+
+  struct Stats {
+    size_t batch_size = 0;
+    double p99_ms = 0;          // last control window
+    double arrival_rate = 0;    // records/s, smoothed
+    uint64_t batches = 0;
+  };
+
+  Stats stats() const {
+    return {size_, last_p99_ms_, arrival_rate_, batches_};
+  }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  void adjust() {
+    double p99_ms = window_.quantile(0.99) / 1e6;
+    last_p99_ms_ = p99_ms;
+    double scaled = static_cast<double>(size_);
+    if (p99_ms > options_.target_p99_ms) {
+      scaled *= 0.7;  // overshoot: back off fast
+    } else if (p99_ms < options_.target_p99_ms * 0.5) {
+      scaled = scaled * 1.25 + 1;  // comfortable: probe upward
+    }
+    // Never batch more than the arrival rate can deliver inside the
+    // latency budget.
+    if (arrival_rate_ > 0) {
+      double budget = arrival_rate_ * options_.target_p99_ms / 1e3;
+      scaled = std::min(scaled, std::max(budget, 1.0));
+    }
+    size_ = std::clamp(static_cast<size_t>(scaled), options_.min_batch,
+                       options_.max_batch);
+    window_ = agg::DDSketch(0.01, 512);  // fresh window per step
+  }
+
+  Options options_;
+  size_t size_;
+  agg::DDSketch window_;  // delivery latency (ns) this window
+  double arrival_rate_ = 0;
+  double last_p99_ms_ = 0;
+  uint64_t batches_ = 0;
+  Clock::time_point last_arrival_;
+};
+
+}  // namespace proga::pipeline
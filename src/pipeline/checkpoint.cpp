@@ -0,0 +1,236 @@
+#include "pipeline/checkpoint.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#include "util/binary.h"
+
+namespace proga::pipeline {
+
+namespace {
+
+constexpr char kMagic[8] = {'P', 'C', 'K', 'P', 'T', '0', '0', '1'};
+
+}  // namespace
+
+void Checkpoint::encode(const std::vector<uint64_t>& offsets,
+                        const agg::Aggregator* aggregator,
+                        std::vector<uint8_t>& out) {
+  out.clear();
+  util::put_bytes(out, kMagic, sizeof(kMagic));
+  util::put_u64(out, offsets.size());
+  for (uint64_t offset : offsets) util::put_u64(out, offset);
+  util::put_u32(out, aggregator != nullptr ? 1 : 0);
+  if (aggregator != nullptr) aggregator->serialize(out);
+}
+
+bool Checkpoint::decode(const std::vector<uint8_t>& bytes,
+                        std::vector<uint64_t>& offsets,
+                        agg::Aggregator* aggregator) {
+  util::BinaryCursor in(bytes.data(), bytes.size());
+  char magic[8];
+  uint64_t offset_count = 0;
+  if (!in.get_bytes(magic, sizeof(magic)) ||
+      memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+      !in.get_u64(offset_count) || offset_count > (uint64_t{1} << 32)) {
+    return false;
+  }
+  offsets.clear();
+  for (uint64_t i = 0; i < offset_count; ++i) {
+    uint64_t offset = 0;
+    if (!in.get_u64(offset)) return false;
+    offsets.push_back(offset);
+  }
+  uint32_t has_aggregator = 0;
+  if (!in.get_u32(has_aggregator)) return false;
+  if (has_aggregator != 0) {
+    // A snapshot with state restores only into a caller that wants it.
+    if (aggregator == nullptr || !aggregator->deserialize(in)) return false;
+  }
+  return in.done();
+}
+
+bool Checkpoint::store(const std::string& path,
+                       const std::vector<uint8_t>& bytes) {
+  std::string tmp = path + ".tmp";
+  int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) return false;
+  const uint8_t* p = bytes.data();
+  size_t n = bytes.size();
+  bool ok = true;
+  while (n > 0) {
+    ssize_t written = ::write(fd, p, n);
+    if (written < 0) {
+      if (errno == EINTR) continue;
+      ok = false;
+      break;
+    }
+    p += written;
+    n -= static_cast<size_t>(written);
+  }
+  if (ok && fdatasync(fd) != 0) ok = false;
+  if (::close(fd) != 0) ok = false;
+  if (ok && ::rename(tmp.c_str(), path.c_str()) != 0) ok = false;
+  if (!ok) ::unlink(tmp.c_str());
+  return ok;
+}
+
+std::optional<std::vector<uint8_t>> Checkpoint::load_bytes(
+    const std::string& path) {
+  std::FILE* f = fopen(path.c_str(), "rb");
+  if (f == nullptr) return std::nullopt;
+  std::vector<uint8_t> bytes;
+  uint8_t buf[1 << 16];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+    bytes.insert(bytes.end(), buf, buf + n);
+  }
+  bool ok = ferror(f) == 0;
+  fclose(f);
+  if (!ok) return std::nullopt;
+  return bytes;
+}
+
+bool Checkpoint::save(const std::string& path,
+                      const std::vector<uint64_t>& offsets,
+                      const agg::Aggregator* aggregator) {
+  std::vector<uint8_t> bytes;
+  encode(offsets, aggregator, bytes);
+  return store(path, bytes);
+}
+
+bool Checkpoint::load(const std::string& path, std::vector<uint64_t>& offsets,
+                      agg::Aggregator* aggregator) {
+  auto bytes = load_bytes(path);
+  return bytes && decode(*bytes, offsets, aggregator);
+}
+
+struct CheckpointWriter::Impl {
+  std::string path;
+  Options options;
+
+  std::mutex mu;
+  std::condition_variable writer_cv;  // work queued or stop
+  std::condition_variable done_cv;    // a write finished
+  std::vector<uint8_t> pending;       // latest snapshot awaiting write
+  bool has_pending = false;
+  bool stop = false;
+  bool io_error = false;
+  uint64_t queued = 0;
+  std::atomic<uint64_t> written{0};
+  std::chrono::steady_clock::time_point last_snapshot;
+  std::thread writer;
+
+  explicit Impl(std::string snapshot_path, const Options& opts)
+      : path(std::move(snapshot_path)),
+        options(opts),
+        last_snapshot(std::chrono::steady_clock::now() -
+                      std::chrono::hours(1)) {}
+
+  ~Impl() {
+    {
+      std::unique_lock<std::mutex> lock(mu);
+      stop = true;
+      writer_cv.notify_one();
+    }
+    if (writer.joinable()) writer.join();
+  }
+
+  void writer_loop() {
+    std::unique_lock<std::mutex> lock(mu);
+    for (;;) {
+      writer_cv.wait(lock, [&] { return has_pending || stop; });
+      if (!has_pending && stop) return;
+      // Take the newest snapshot; intermediate ones that were replaced
+      // while we wrote are intentionally skipped (only the latest
+      // position matters for resume).
+      std::vector<uint8_t> bytes = std::move(pending);
+      has_pending = false;
+      lock.unlock();
+      bool ok = Checkpoint::store(path, bytes);
+      lock.lock();
+      if (!ok) io_error = true;
+      written.fetch_add(1, std::memory_order_relaxed);
+      done_cv.notify_all();
+    }
+  }
+
+  bool snapshot(const std::vector<uint64_t>& offsets,
+                const agg::Aggregator* aggregator, bool force) {
+    auto now = std::chrono::steady_clock::now();
+    {
+      std::unique_lock<std::mutex> lock(mu);
+      if (io_error) return false;
+      if (!force &&
+          now - last_snapshot <
+              std::chrono::milliseconds(options.interval_ms)) {
+        return false;
+      }
+      last_snapshot = now;
+    }
+    // Serialize outside the lock: this copy is the only work on the
+    // caller's thread.
+    std::vector<uint8_t> bytes;
+    Checkpoint::encode(offsets, aggregator, bytes);
+    {
+      std::unique_lock<std::mutex> lock(mu);
+      pending = std::move(bytes);
+      if (!has_pending) ++queued;
+      has_pending = true;
+      writer_cv.notify_one();
+    }
+    return true;
+  }
+
+  bool flush() {
+    std::unique_lock<std::mutex> lock(mu);
+    done_cv.wait(lock, [&] {
+      return io_error ||
+             (!has_pending &&
+              written.load(std::memory_order_relaxed) >= queued);
+    });
+    return !io_error;
+  }
+};
+
+std::optional<CheckpointWriter> CheckpointWriter::open(const std::string& path,
+                                                       const Options& options) {
+  if (options.interval_ms < 0) return std::nullopt;
+  auto impl = std::make_unique<Impl>(path, options);
+  Impl* raw = impl.get();
+  impl->writer = std::thread([raw] { raw->writer_loop(); });
+  return CheckpointWriter(std::move(impl));
+}
+
+CheckpointWriter::CheckpointWriter(std::unique_ptr<Impl> impl)
+    : impl_(std::move(impl)) {}
+CheckpointWriter::CheckpointWriter(CheckpointWriter&&) noexcept = default;
+CheckpointWriter& CheckpointWriter::operator=(CheckpointWriter&&) noexcept =
+    default;
+CheckpointWriter::~CheckpointWriter() = default;
+
+bool CheckpointWriter::maybe_checkpoint(const std::vector<uint64_t>& offsets,
+                                        const agg::Aggregator* aggregator) {
+  return impl_->snapshot(offsets, aggregator, false);
+}
+
+bool CheckpointWriter::checkpoint_now(const std::vector<uint64_t>& offsets,
+                                      const agg::Aggregator* aggregator) {
+  return impl_->snapshot(offsets, aggregator, true);
+}
+
+bool CheckpointWriter::flush() { return impl_->flush(); }
+
+uint64_t CheckpointWriter::snapshots_written() const {
+  return impl_->written.load(std::memory_order_relaxed);
+}
+
+}  // namespace proga::pipeline
@@ -0,0 +1,94 @@
+#pragma once
+
+// Snapshots for resumable long replays.
+//
+// A checkpoint captures the replay position (one byte offset per input
+// file/shard) and the live aggregation state. Checkpoint::encode() and
+// decode() are the format; CheckpointWriter runs the pipeline side:
+// maybe_checkpoint() serializes the state into a buffer (memcpy-scale,
+// well under a millisecond for typical group counts — this copy is
+// what isolates the snapshot from further updates) and a background
+// thread does the tmp-file write + rename, so the hot path never waits
+// on disk and a crash leaves either the old snapshot or the new one,
+// never a torn file. On restart, Checkpoint::load() hands back the
+// offsets and aggregator to continue from.
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "agg/aggregator.h"
+
+namespace proga::pipeline {
+
+class Checkpoint {
+ public:
+  // Serialized snapshot: magic, per-shard offsets, aggregation state.
+  static void encode(const std::vector<uint64_t>& offsets,
+                     const agg::Aggregator* aggregator,
+                     std::vector<uint8_t>& out);
+
+  // Restores offsets and (when the snapshot holds one) the aggregator,
+  // which must be freshly constructed with the original options.
+  static bool decode(const std::vector<uint8_t>& bytes,
+                     std::vector<uint64_t>& offsets,
+                     agg::Aggregator* aggregator);
+
+  // Atomic persistence: write to "<path>.tmp", fdatasync, rename.
+  static bool store(const std::string& path,
+                    const std::vector<uint8_t>& bytes);
+  static std::optional<std::vector<uint8_t>> load_bytes(
+      const std::string& path);
+
+  // store(encode(...)) / decode(load_bytes(...)), for callers that
+  // don't need the background writer.
+  static bool save(const std::string& path,
+                   const std::vector<uint64_t>& offsets,
+                   const agg::Aggregator* aggregator);
+  static bool load(const std::string& path, std::vector<uint64_t>& offsets,
+                   agg::Aggregator* aggregator);
+};
+
+// Periodic checkpointing off the hot path. The caller invokes
+// maybe_checkpoint() from its replay loop; at most one snapshot per
+// interval is serialized, and the disk write happens on the writer's
+// own thread.
+class CheckpointWriter {
+ public:
+  struct Options {
+    int interval_ms = 1000;
+  };
+
+  static std::optional<CheckpointWriter> open(const std::string& path,
+                                              const Options& options);
+  static std::optional<CheckpointWriter> open(const std::string& path) {
+    return open(path, Options());
+  }
+
+  CheckpointWriter(CheckpointWriter&&) noexcept;
+  CheckpointWriter& operator=(CheckpointWriter&&) noexcept;
+  ~CheckpointWriter();  // waits for the in-flight write
+
+  // Snapshots if at least interval_ms passed since the last one.
+  // Returns true when a snapshot was taken (queued for writing).
+  bool maybe_checkpoint(const std::vector<uint64_t>& offsets,
+                        const agg::Aggregator* aggregator);
+
+  // Unconditional snapshot; still returns without waiting on disk.
+  bool checkpoint_now(const std::vector<uint64_t>& offsets,
+                      const agg::Aggregator* aggregator);
+
+  // Blocks until every queued snapshot is on disk.
+  bool flush();
+
+  uint64_t snapshots_written() const;
+
+ private:
+  struct Impl;
+  explicit CheckpointWriter(std::unique_ptr<Impl> impl);
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace proga::pipeline
@@ -0,0 +1,304 @@
+#include "pipeline/coro_reader.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "jsonl/parser.h"
+#include "pipeline/adaptive_batch.h"
+
+namespace proga::pipeline {
+
+using Clock = std::chrono::steady_clock;
+
+struct CoroExecutor::Impl {
+  struct PollEntry {
+    Clock::time_point due;
+    int interval_ms;
+    std::function<bool()> ready;
+    std::coroutine_handle<> handle;
+  };
+
+  std::mutex mu;
+  std::condition_variable cv;       // work or a due poll
+  std::condition_variable idle_cv;  // a task finished
+  std::deque<std::coroutine_handle<>> ready;
+  std::vector<PollEntry> polls;
+  size_t active_tasks = 0;
+  bool stop = false;
+  std::vector<std::thread> workers;
+
+  void worker_loop() {
+    std::unique_lock<std::mutex> lock(mu);
+    for (;;) {
+      // Ready coroutines first; otherwise service the earliest poll.
+      if (!ready.empty()) {
+        std::coroutine_handle<> handle = ready.front();
+        ready.pop_front();
+        lock.unlock();
+        handle.resume();
+        lock.lock();
+        continue;
+      }
+      if (stop) return;
+      if (polls.empty()) {
+        cv.wait(lock);
+        continue;
+      }
+      size_t earliest = 0;
+      for (size_t i = 1; i < polls.size(); ++i) {
+        if (polls[i].due < polls[earliest].due) earliest = i;
+      }
+      Clock::time_point due = polls[earliest].due;
+      Clock::time_point now = Clock::now();
+      if (now < due) {
+        cv.wait_until(lock, due);
+        continue;
+      }
+      PollEntry entry = std::move(polls[earliest]);
+      polls.erase(polls.begin() + static_cast<ptrdiff_t>(earliest));
+      lock.unlock();
+      bool is_ready = entry.ready();
+      lock.lock();
+      if (is_ready) {
+        ready.push_back(entry.handle);
+        cv.notify_one();
+      } else {
+        entry.due = Clock::now() + std::chrono::milliseconds(entry.interval_ms);
+        polls.push_back(std::move(entry));
+      }
+    }
+  }
+};
+
+CoroExecutor::CoroExecutor(unsigned num_threads) : impl_(new Impl) {
+  if (num_threads == 0) num_threads = 1;
+  for (unsigned i = 0; i < num_threads; ++i) {
+    Impl* raw = impl_.get();
+    impl_->workers.emplace_back([raw] { raw->worker_loop(); });
+  }
+}
+
+CoroExecutor::~CoroExecutor() {
+  wait_idle();
+  {
+    std::unique_lock<std::mutex> lock(impl_->mu);
+    impl_->stop = true;
+    impl_->cv.notify_all();
+  }
+  for (auto& worker : impl_->workers) worker.join();
+}
+
+void CoroExecutor::spawn(CoroTask task) {
+  std::coroutine_handle<CoroTask::promise_type> handle = task.handle_;
+  task.handle_ = nullptr;  // ownership passes to the executor
+  handle.promise().executor = this;
+  {
+    std::unique_lock<std::mutex> lock(impl_->mu);
+    ++impl_->active_tasks;
+    impl_->ready.push_back(handle);
+    impl_->cv.notify_one();
+  }
+}
+
+void CoroExecutor::wait_idle() {
+  std::unique_lock<std::mutex> lock(impl_->mu);
+  impl_->idle_cv.wait(lock, [&] { return impl_->active_tasks == 0; });
+}
+
+void CoroExecutor::post(std::coroutine_handle<> handle) {
+  std::unique_lock<std::mutex> lock(impl_->mu);
+  impl_->ready.push_back(handle);
+  impl_->cv.notify_one();
+}
+
+void CoroExecutor::schedule_poll(std::function<bool()> ready,
+                                 std::coroutine_handle<> handle,
+                                 int interval_ms) {
+  Impl::PollEntry entry;
+  entry.interval_ms = interval_ms > 0 ? interval_ms : 1;
+  entry.due = Clock::now() + std::chrono::milliseconds(entry.interval_ms);
+  entry.ready = std::move(ready);
+  entry.handle = handle;
+  std::unique_lock<std::mutex> lock(impl_->mu);
+  impl_->polls.push_back(std::move(entry));
+  impl_->cv.notify_one();
+}
+
+void CoroExecutor::task_finished() {
+  std::unique_lock<std::mutex> lock(impl_->mu);
+  --impl_->active_tasks;
+  if (impl_->active_tasks == 0) impl_->idle_cv.notify_all();
+}
+
+void detail::task_done(CoroExecutor* executor) {
+  if (executor != nullptr) executor->task_finished();
+}
+
+struct JsonlStream::Impl {
+  CoroExecutor* executor = nullptr;
+  Options options;
+  int fd = -1;
+
+  std::mutex mu;
+  uint64_t offset = 0;
+  std::string carry;  // partial trailing line
+  std::vector<std::string> pending;
+  bool stopped = false;
+  std::atomic<uint64_t> delivered{0};
+  AdaptiveBatcher batcher;
+  // When the oldest still-undelivered record was buffered; anchors the
+  // delivery latency fed back to the batcher.
+  Clock::time_point oldest_pending;
+  bool have_oldest = false;
+
+  ~Impl() {
+    if (fd >= 0) ::close(fd);
+  }
+
+  // Pulls whatever the file has past `offset` into pending lines.
+  void refill() {
+    char buf[64 << 10];
+    for (;;) {
+      ssize_t n = pread(fd, buf, sizeof(buf), static_cast<off_t>(offset));
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) return;
+      offset += static_cast<uint64_t>(n);
+      const char* p = buf;
+      const char* end = buf + n;
+      while (p < end) {
+        const char* nl =
+            jsonl::detail::find_byte(p, static_cast<size_t>(end - p), '\n');
+        if (nl == nullptr) {
+          carry.append(p, static_cast<size_t>(end - p));
+          break;
+        }
+        carry.append(p, static_cast<size_t>(nl - p));
+        if (!carry.empty() && carry.back() == '\r') carry.pop_back();
+        if (!carry.empty()) pending.push_back(std::move(carry));
+        carry.clear();
+        p = nl + 1;
+      }
+    }
+  }
+
+  size_t batch_limit() const {
+    return options.adaptive
+               ? std::min(batcher.batch_size(), options.max_batch_records)
+               : options.max_batch_records;
+  }
+
+  // Fills `batch`; true when it carries records or the end marker.
+  bool try_fill(Batch& batch) {
+    std::unique_lock<std::mutex> lock(mu);
+    size_t limit = batch_limit();
+    if (pending.size() < limit) {
+      bool was_empty = pending.empty();
+      refill();
+      if (was_empty && !pending.empty()) {
+        oldest_pending = Clock::now();
+        have_oldest = true;
+      }
+    }
+    if (!pending.empty()) {
+      size_t take = std::min(limit, pending.size());
+      batch.records.assign(std::make_move_iterator(pending.begin()),
+                           std::make_move_iterator(pending.begin() +
+                                                   static_cast<ptrdiff_t>(
+                                                       take)));
+      pending.erase(pending.begin(),
+                    pending.begin() + static_cast<ptrdiff_t>(take));
+      delivered.fetch_add(take, std::memory_order_relaxed);
+      if (options.adaptive) {
+        auto now = Clock::now();
+        uint64_t delivery_ns =
+            have_oldest ? static_cast<uint64_t>(
+                              std::chrono::duration_cast<
+                                  std::chrono::nanoseconds>(
+                                  now - oldest_pending)
+                                  .count())
+                        : 0;
+        batcher.on_batch(take, delivery_ns);
+        // Records left behind become the next batch's oldest.
+        oldest_pending = now;
+        have_oldest = !pending.empty();
+      }
+      return true;
+    }
+    if (stopped || !options.follow) {
+      // Surface a final partial line (no trailing newline) on the way
+      // out.
+      if (!carry.empty()) {
+        batch.records.push_back(std::move(carry));
+        carry.clear();
+        delivered.fetch_add(1, std::memory_order_relaxed);
+      }
+      batch.end_of_stream = true;
+      return true;
+    }
+    return false;
+  }
+};
+
+std::optional<JsonlStream> JsonlStream::open(CoroExecutor& executor,
+                                             const std::string& path,
+                                             const Options& options) {
+  auto impl = std::make_unique<Impl>();
+  impl->executor = &executor;
+  impl->options = options;
+  impl->fd = ::open(path.c_str(), O_RDONLY);
+  if (impl->fd < 0) return std::nullopt;
+  if (options.adaptive) {
+    AdaptiveBatcher::Options batch_options;
+    batch_options.target_p99_ms = options.target_p99_ms;
+    batch_options.max_batch = options.max_batch_records;
+    batch_options.initial_batch =
+        std::min<size_t>(64, options.max_batch_records);
+    impl->batcher = AdaptiveBatcher(batch_options);
+  }
+  return JsonlStream(std::move(impl));
+}
+
+JsonlStream::JsonlStream(std::unique_ptr<Impl> impl)
+    : impl_(std::move(impl)) {}
+JsonlStream::JsonlStream(JsonlStream&&) noexcept = default;
+JsonlStream& JsonlStream::operator=(JsonlStream&&) noexcept = default;
+JsonlStream::~JsonlStream() = default;
+
+bool JsonlStream::NextBatchAwaitable::await_ready() {
+  return stream->try_fill(batch);
+}
+
+void JsonlStream::NextBatchAwaitable::await_suspend(
+    std::coroutine_handle<> handle) {
+  Impl* s = stream;
+  Batch* b = &batch;
+  s->executor->schedule_poll([s, b] { return s->try_fill(*b); }, handle,
+                             s->options.poll_interval_ms);
+}
+
+JsonlStream::NextBatchAwaitable JsonlStream::next_batch() {
+  return NextBatchAwaitable{impl_.get(), {}};
+}
+
+void JsonlStream::stop() {
+  std::unique_lock<std::mutex> lock(impl_->mu);
+  impl_->stopped = true;
+}
+
+uint64_t JsonlStream::records_delivered() const {
+  return impl_->delivered.load(std::memory_order_relaxed);
+}
+
+size_t JsonlStream::current_batch_size() const {
+  std::unique_lock<std::mutex> lock(impl_->mu);
+  return impl_->batch_limit();
+}
+
+}  // namespace proga::pipeline
@@ -0,0 +1,178 @@
+#pragma once
+
+// Coroutine consumer API for followed logs.
+//
+// A service following hundreds of logs should not pay a blocking
+// thread per log. JsonlStream exposes `co_await stream.next_batch()`:
+// when data is buffered the coroutine continues immediately; when the
+// log is idle the coroutine suspends and its poll registers with the
+// CoroExecutor's timer wheel, so thousands of streams multiplex onto a
+// small worker pool and an idle stream costs a timer entry instead of
+// a thread stack.
+//
+//   CoroTask consume(pipeline::JsonlStream& stream) {
+//     for (;;) {
+//       auto batch = co_await stream.next_batch();
+//       for (const auto& line : batch.records) handle(line);
+//       if (batch.end_of_stream) co_return;
+//     }
+//   }
+//   executor.spawn(consume(stream));
+//
+// Streams must outlive the coroutines consuming them; CoroExecutor's
+// destructor waits for every spawned task.
+
+#include <coroutine>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace proga::pipeline {
+
+class CoroExecutor;
+
+namespace detail {
+// Completion hook for CoroTask's final awaiter (the frame is already
+// destroyed when this runs).
+void task_done(CoroExecutor* executor);
+}  // namespace detail
+
+// Fire-and-forget coroutine accepted by CoroExecutor::spawn(). The
+// frame starts suspended and is destroyed when the body returns.
+class CoroTask {
+ public:
+  struct promise_type {
+    CoroExecutor* executor = nullptr;
+
+    CoroTask get_return_object() {
+      return CoroTask(
+          std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    auto final_suspend() noexcept {
+      struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+        void await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+          CoroExecutor* executor = h.promise().executor;
+          h.destroy();
+          detail::task_done(executor);
+        }
+        void await_resume() noexcept {}
+      };
+      return FinalAwaiter{};
+    }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+
+  CoroTask(CoroTask&& other) noexcept : handle_(other.handle_) {
+    other.handle_ = nullptr;
+  }
+  CoroTask(const CoroTask&) = delete;
+  ~CoroTask() {
+    if (handle_) handle_.destroy();  // never spawned
+  }
+
+ private:
+  friend class CoroExecutor;
+  explicit CoroTask(std::coroutine_handle<promise_type> handle)
+      : handle_(handle) {}
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+class CoroExecutor {
+ public:
+  explicit CoroExecutor(unsigned num_threads = 1);
+  ~CoroExecutor();  // waits for all spawned tasks, then stops workers
+
+  CoroExecutor(const CoroExecutor&) = delete;
+  CoroExecutor& operator=(const CoroExecutor&) = delete;
+
+  // Takes ownership of the coroutine and schedules its first resume.
+  void spawn(CoroTask task);
+
+  // Blocks until every spawned task has finished.
+  void wait_idle();
+
+  // Awaitable plumbing: posts a handle to the ready queue, or arms a
+  // periodic poll that resumes the handle once `ready` returns true.
+  void post(std::coroutine_handle<> handle);
+  void schedule_poll(std::function<bool()> ready,
+                     std::coroutine_handle<> handle, int interval_ms);
+
+ private:
+  friend void detail::task_done(CoroExecutor* executor);
+  void task_finished();
+
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+// One followed JSONL log, consumed in batches from coroutines.
+class JsonlStream {
+ public:
+  struct Options {
+    size_t max_batch_records = 256;
+    int poll_interval_ms = 10;
+    // follow=false ends the stream at the current EOF instead of
+    // waiting for appends.
+    bool follow = true;
+    // adaptive=true lets an AdaptiveBatcher resize batches (up to
+    // max_batch_records) toward target_p99_ms delivery latency, so the
+    // same binary serves replay and live-follow well.
+    bool adaptive = false;
+    double target_p99_ms = 10.0;
+  };
+
+  struct Batch {
+    std::vector<std::string> records;  // complete lines, no newline
+    bool end_of_stream = false;
+  };
+
+  static std::optional<JsonlStream> open(CoroExecutor& executor,
+                                         const std::string& path,
+                                         const Options& options);
+  static std::optional<JsonlStream> open(CoroExecutor& executor,
+                                         const std::string& path) {
+    return open(executor, path, Options());
+  }
+
+  JsonlStream(JsonlStream&&) noexcept;
+  JsonlStream& operator=(JsonlStream&&) noexcept;
+  ~JsonlStream();
+
+  struct Impl;
+
+  // Awaitable: resumes with at least one record, or with
+  // end_of_stream set after stop() (or at EOF when not following).
+  struct NextBatchAwaitable {
+    Impl* stream;
+    Batch batch;
+
+    bool await_ready();
+    void await_suspend(std::coroutine_handle<> handle);
+    Batch await_resume() { return std::move(batch); }
+  };
+
+  NextBatchAwaitable next_batch();
+
+  // Makes pending and future next_batch() calls finish with
+  // end_of_stream once the remaining buffered data is drained.
+  void stop();
+
+  uint64_t records_delivered() const;
+
+  // The batch size currently in effect (max_batch_records unless
+  // adaptive mode has picked something smaller).
+  size_t current_batch_size() const;
+
+ private:
+  explicit JsonlStream(std::unique_ptr<Impl> impl);
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace proga::pipeline
@@ -0,0 +1,113 @@
+#include "pipeline/parallel_reader.h"
+
+#include "sched/numa.h"
+#include "util/instrument.h"
+
+namespace proga::pipeline {
+
+namespace {
+constexpr size_t kQueueCapacity = 4096;
+}
+
+std::optional<ParallelJsonlReader> ParallelJsonlReader::open(
+    const std::string& path, unsigned num_threads) {
+  auto file = io::MmapFile::open(path, io::MmapFile::Advice::kSequential);
+  if (!file) return std::nullopt;
+  if (num_threads == 0) {
+    num_threads = std::thread::hardware_concurrency();
+    if (num_threads == 0) num_threads = 1;
+  }
+  ParallelJsonlReader reader(std::move(*file));
+  reader.start(num_threads);
+  return reader;
+}
+
+void ParallelJsonlReader::start(unsigned num_threads) {
+  std::string_view data = file_.view();
+  // Chunk boundaries advance to one past the next newline so every
+  // record belongs to exactly one worker.
+  std::vector<size_t> bounds;
+  bounds.push_back(0);
+  size_t target = data.size() / num_threads + 1;
+  for (unsigned i = 1; i < num_threads; ++i) {
+    size_t pos = std::min(i * target, data.size());
+    if (pos < data.size()) {
+      const char* nl =
+          jsonl::detail::find_byte(data.data() + pos, data.size() - pos, '\n');
+      pos = nl != nullptr ? static_cast<size_t>(nl - data.data()) + 1
+                          : data.size();
+    }
+    if (pos > bounds.back()) bounds.push_back(pos);
+  }
+  bounds.push_back(data.size());
+
+  for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+    workers_.push_back(std::make_unique<Worker>(kQueueCapacity));
+  }
+  const sched::NumaTopology& topology = sched::NumaTopology::get();
+  for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+    Worker* w = workers_[i].get();
+    const std::atomic<bool>* stop = stop_.get();
+    std::string_view chunk = data.substr(bounds[i], bounds[i + 1] - bounds[i]);
+    // Workers spread round-robin over NUMA nodes; a pinned worker
+    // first-faults its chunk's pages, so the file data lands on its
+    // own node and the scan never crosses the interconnect. The SPSC
+    // queue is the only cross-node traffic, at the merge stage.
+    const sched::NumaNode* node =
+        topology.node_count() > 1 ? &topology.node_for_worker(i) : nullptr;
+    w->thread = std::thread([w, chunk, stop, node] {
+      if (node != nullptr) sched::NumaTopology::pin_current_thread(*node);
+      scan_chunk(*w, chunk, stop);
+    });
+  }
+}
+
+void ParallelJsonlReader::scan_chunk(Worker& worker, std::string_view chunk,
+                                     const std::atomic<bool>* stop) {
+  jsonl::JsonlReader scanner(chunk);
+  jsonl::RecordView rec;
+  while (scanner.next(rec)) {
+    while (!worker.queue.try_push(rec.raw())) {
+      if (stop->load(std::memory_order_relaxed)) {
+        worker.done.store(true, std::memory_order_release);
+        return;
+      }
+      std::this_thread::yield();  // consumer back-pressure
+    }
+  }
+  worker.done.store(true, std::memory_order_release);
+}
+
+bool ParallelJsonlReader::next(jsonl::RecordView& out) {
+  PROGA_TIMED_SCOPE("queue.parallel_pop");
+  while (current_ < workers_.size()) {
+    Worker& w = *workers_[current_];
+    std::string_view line;
+    if (w.queue.try_pop(line)) {
+      out = jsonl::RecordView(line);
+      ++records_;
+      return true;
+    }
+    if (w.done.load(std::memory_order_acquire)) {
+      // Drain anything pushed between the failed pop and the flag.
+      if (w.queue.try_pop(line)) {
+        out = jsonl::RecordView(line);
+        ++records_;
+        return true;
+      }
+      ++current_;
+      continue;
+    }
+    std::this_thread::yield();
+  }
+  return false;
+}
+
+ParallelJsonlReader::~ParallelJsonlReader() {
+  if (stop_) stop_->store(true, std::memory_order_relaxed);
+  for (auto& w : workers_) {
+    if (w->thread.joinable()) w->thread.join();
+  }
+}
+
+}  // namespace proga::pipeline
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "concurrency/spsc_queue.h"
+#include "io/mmap_file.h"
+#include "jsonl/parser.h"
+
+namespace proga::pipeline {
+
+// Parallel JSONL ingest over a memory-mapped log. The file is split
+// into one byte chunk per worker, each chunk aligned forward to a
+// newline boundary so no record straddles two workers. Workers scan
+// their chunk and feed record views through a bounded SPSC ring; the
+// consumer drains the rings in chunk order, so next() yields records
+// in exactly the order the serial readers would.
+class ParallelJsonlReader {
+ public:
+  // Maps `path` and starts `num_threads` scan workers (0 means one per
+  // hardware thread). Returns nullopt if the file cannot be mapped.
+  static std::optional<ParallelJsonlReader> open(const std::string& path,
+                                                unsigned num_threads = 0);
+
+  ~ParallelJsonlReader();
+  ParallelJsonlReader(ParallelJsonlReader&&) = default;
+
+  // Same contract as the serial readers: views alias the mapping and
+  // stay valid for the reader's lifetime.
+  bool next(jsonl::RecordView& out);
+
+  size_t records_read() const { return records_; }
+  unsigned worker_count() const { return static_cast<unsigned>(workers_.size()); }
+
+ private:
+  struct Worker {
+    explicit Worker(size_t queue_capacity) : queue(queue_capacity) {}
+    concurrency::SpscQueue<std::string_view> queue;
+    std::atomic<bool> done{false};
+    std::thread thread;
+  };
+
+  explicit ParallelJsonlReader(io::MmapFile file) : file_(std::move(file)) {}
+  void start(unsigned num_threads);
+  // Static so worker threads never touch `this`, which may be moved
+  // between open() and the first next().
+  static void scan_chunk(Worker& worker, std::string_view chunk,
+                         const std::atomic<bool>* stop);
+
+  io::MmapFile file_;
+  std::unique_ptr<std::atomic<bool>> stop_ =
+      std::make_unique<std::atomic<bool>>(false);
+  std::vector<std::unique_ptr<Worker>> workers_;
+  size_t current_ = 0;
+  size_t records_ = 0;
+};
+
+}  // namespace proga::pipeline
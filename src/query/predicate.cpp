@@ -0,0 +1,237 @@
+#include "query/predicate.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+namespace proga::query {
+
+namespace {
+
+enum class CmpOp { kEq, kNe, kLt, kLe, kGt, kGe, kContains };
+
+}  // namespace
+
+struct Predicate::Node {
+  enum class Kind { kAnd, kOr, kNot, kCmp };
+
+  Kind kind;
+  std::unique_ptr<Node> lhs;
+  std::unique_ptr<Node> rhs;
+
+  // kCmp payload.
+  CmpOp op = CmpOp::kEq;
+  std::string field;
+  bool numeric = false;
+  double num = 0;
+  std::string str;
+
+  bool eval(const jsonl::RecordView& rec) const {
+    switch (kind) {
+      case Kind::kAnd:
+        return lhs->eval(rec) && rhs->eval(rec);
+      case Kind::kOr:
+        return lhs->eval(rec) || rhs->eval(rec);
+      case Kind::kNot:
+        return !lhs->eval(rec);
+      case Kind::kCmp:
+        break;
+    }
+    if (numeric) {
+      auto v = rec.double_field(field);
+      if (!v) return false;
+      switch (op) {
+        case CmpOp::kEq: return *v == num;
+        case CmpOp::kNe: return *v != num;
+        case CmpOp::kLt: return *v < num;
+        case CmpOp::kLe: return *v <= num;
+        case CmpOp::kGt: return *v > num;
+        case CmpOp::kGe: return *v >= num;
+        case CmpOp::kContains: return false;
+      }
+      return false;
+    }
+    auto v = rec.string_field(field);
+    if (!v) return false;
+    switch (op) {
+      case CmpOp::kEq: return *v == str;
+      case CmpOp::kNe: return *v != str;
+      case CmpOp::kContains:
+        return v->find(str) != std::string_view::npos;
+      case CmpOp::kLt: return *v < str;
+      case CmpOp::kLe: return *v <= str;
+      case CmpOp::kGt: return *v > str;
+      case CmpOp::kGe: return *v >= str;
+    }
+    return false;
+  }
+};
+
+namespace {
+
+// Recursive-descent parser over the expression text.
+class Parser {
+ public:
+  explicit Parser(std::string_view text) : p_(text.data()), end_(p_ + text.size()) {}
+
+  std::unique_ptr<Predicate::Node> parse() {
+    auto node = parse_or();
+    skip_ws();
+    if (p_ != end_) return nullptr;  // trailing junk
+    return node;
+  }
+
+ private:
+  using Node = Predicate::Node;
+
+  void skip_ws() {
+    while (p_ < end_ && (*p_ == ' ' || *p_ == '\t')) ++p_;
+  }
+
+  bool consume(const char* tok) {
+    skip_ws();
+    size_t len = strlen(tok);
+    if (static_cast<size_t>(end_ - p_) < len) return false;
+    if (strncmp(p_, tok, len) != 0) return false;
+    p_ += len;
+    return true;
+  }
+
+  std::unique_ptr<Node> parse_or() {
+    auto lhs = parse_and();
+    while (lhs != nullptr && consume("||")) {
+      auto rhs = parse_and();
+      if (rhs == nullptr) return nullptr;
+      auto node = std::make_unique<Node>();
+      node->kind = Node::Kind::kOr;
+      node->lhs = std::move(lhs);
+      node->rhs = std::move(rhs);
+      lhs = std::move(node);
+    }
+    return lhs;
+  }
+
+  std::unique_ptr<Node> parse_and() {
+    auto lhs = parse_unary();
+    while (lhs != nullptr && consume("&&")) {
+      auto rhs = parse_unary();
+      if (rhs == nullptr) return nullptr;
+      auto node = std::make_unique<Node>();
+      node->kind = Node::Kind::kAnd;
+      node->lhs = std::move(lhs);
+      node->rhs = std::move(rhs);
+      lhs = std::move(node);
+    }
+    return lhs;
+  }
+
+  std::unique_ptr<Node> parse_unary() {
+    skip_ws();
+    if (consume("!")) {
+      auto operand = parse_unary();
+      if (operand == nullptr) return nullptr;
+      auto node = std::make_unique<Node>();
+      node->kind = Node::Kind::kNot;
+      node->lhs = std::move(operand);
+      return node;
+    }
+    if (consume("(")) {
+      auto inner = parse_or();
+      if (inner == nullptr || !consume(")")) return nullptr;
+      return inner;
+    }
+    return parse_cmp();
+  }
+
+  std::unique_ptr<Node> parse_cmp() {
+    skip_ws();
+    const char* begin = p_;
+    while (p_ < end_ && (isalnum(static_cast<unsigned char>(*p_)) ||
+                         *p_ == '_' || *p_ == '.')) {
+      ++p_;
+    }
+    if (p_ == begin) return nullptr;
+    auto node = std::make_unique<Node>();
+    node->kind = Node::Kind::kCmp;
+    node->field.assign(begin, p_);
+
+    if (consume("==")) node->op = CmpOp::kEq;
+    else if (consume("!=")) node->op = CmpOp::kNe;
+    else if (consume("<=")) node->op = CmpOp::kLe;
+    else if (consume(">=")) node->op = CmpOp::kGe;
+    else if (consume("<")) node->op = CmpOp::kLt;
+    else if (consume(">")) node->op = CmpOp::kGt;
+    else if (consume("contains")) node->op = CmpOp::kContains;
+    else return nullptr;
+
+    skip_ws();
+    if (p_ < end_ && (*p_ == '"' || *p_ == '\'')) {
+      char quote = *p_++;
+      const char* lit = p_;
+      while (p_ < end_ && *p_ != quote) ++p_;
+      if (p_ == end_) return nullptr;
+      node->str.assign(lit, p_);
+      ++p_;
+      node->numeric = false;
+      if (node->op == CmpOp::kContains && node->str.empty()) return nullptr;
+      return node;
+    }
+    char* num_end = nullptr;
+    node->num = strtod(p_, &num_end);
+    if (num_end == p_ || num_end > end_) return nullptr;
+    p_ = num_end;
+    node->numeric = true;
+    if (node->op == CmpOp::kContains) return nullptr;
+    return node;
+  }
+
+  const char* p_;
+  const char* end_;
+};
+
+// Collects substrings every match must contain: string == and
+// `contains` terms reachable through AND edges only.
+void collect_required(const Predicate::Node& node,
+                      std::vector<std::string>& out) {
+  using Kind = Predicate::Node::Kind;
+  switch (node.kind) {
+    case Kind::kAnd:
+      collect_required(*node.lhs, out);
+      collect_required(*node.rhs, out);
+      return;
+    case Kind::kCmp:
+      if (!node.numeric &&
+          (node.op == CmpOp::kEq || node.op == CmpOp::kContains) &&
+          !node.str.empty()) {
+        out.push_back(node.str);
+      }
+      return;
+    case Kind::kOr:
+    case Kind::kNot:
+      return;  // no guarantee survives these
+  }
+}
+
+}  // namespace
+
+Predicate::Predicate(std::unique_ptr<Node> root) : root_(std::move(root)) {
+  collect_required(*root_, required_);
+}
+
+Predicate::Predicate(Predicate&&) noexcept = default;
+Predicate& Predicate::operator=(Predicate&&) noexcept = default;
+Predicate::~Predicate() = default;
+
+std::optional<Predicate> Predicate::parse(std::string_view expr) {
+  // Copy to guarantee a terminator for strtod in the number path.
+  std::string text(expr);
+  auto root = Parser(text).parse();
+  if (root == nullptr) return std::nullopt;
+  return Predicate(std::move(root));
+}
+
+bool Predicate::matches(const jsonl::RecordView& rec) const {
+  return root_->eval(rec);
+}
+
+}  // namespace proga::query
@@ -0,0 +1,80 @@
+#pragma once
+
+// Predicate expressions over JSONL records, e.g.
+//
+//   method == "POST" && latency_ms > 500
+//   (status >= 500 || url contains "/admin") && method != "GET"
+//
+// Predicates compile once and evaluate against RecordViews using the
+// lazy field API. String equality comparisons under the top-level AND
+// also yield required substrings: any matching line must contain those
+// bytes, so scans can reject non-matching lines with a plain substring
+// search before touching any field.
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "jsonl/parser.h"
+
+namespace proga::query {
+
+class Predicate {
+ public:
+  // Parses an expression; nullopt on syntax error. Comparison
+  // operators: == != < <= > >= and `contains` (strings only).
+  // Literals are numbers or quoted strings; && || ! and parentheses
+  // combine terms.
+  static std::optional<Predicate> parse(std::string_view expr);
+
+  Predicate(Predicate&&) noexcept;
+  Predicate& operator=(Predicate&&) noexcept;
+  ~Predicate();
+
+  bool matches(const jsonl::RecordView& rec) const;
+
+  // Bytes every matching line necessarily contains. Empty when the
+  // expression gives no such guarantee.
+  const std::vector<std::string>& required_substrings() const {
+    return required_;
+  }
+
+  // Raw-line pre-filter: false means the line provably cannot match.
+  bool may_match(std::string_view line) const {
+    for (const std::string& s : required_) {
+      if (line.find(s) == std::string_view::npos) return false;
+    }
+    return true;
+  }
+
+  // Expression AST node; public so the parser implementation can
+  // build trees, but otherwise an implementation detail.
+  struct Node;
+
+ private:
+  explicit Predicate(std::unique_ptr<Node> root);
+
+  std::unique_ptr<Node> root_;
+  std::vector<std::string> required_;
+};
+
+// Scans any reader with the next() contract, invoking `fn` for each
+// record matching `pred`. Non-matching lines are rejected by the
+// substring pre-filter before field materialization where possible.
+// Returns the number of matches.
+template <typename Reader, typename Fn>
+size_t scan(Reader& reader, const Predicate& pred, Fn&& fn) {
+  jsonl::RecordView rec;
+  size_t matches = 0;
+  while (reader.next(rec)) {
+    if (!pred.may_match(rec.raw())) continue;
+    if (!pred.matches(rec)) continue;
+    ++matches;
+    fn(rec);
+  }
+  return matches;
+}
+
+}  // namespace proga::query
@@ -0,0 +1,93 @@
+#include "sched/numa.h"
+
+#include <sched.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace proga::sched {
+
+namespace {
+
+// Parses a sysfs cpulist ("0-3,8,10-11") into CPU ids.
+std::vector<unsigned> parse_cpulist(const char* text) {
+  std::vector<unsigned> cpus;
+  const char* p = text;
+  while (*p != '\0' && *p != '\n') {
+    char* end = nullptr;
+    unsigned long first = strtoul(p, &end, 10);
+    if (end == p) break;
+    unsigned long last = first;
+    p = end;
+    if (*p == '-') {
+      last = strtoul(p + 1, &end, 10);
+      p = end;
+    }
+    for (unsigned long cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(static_cast<unsigned>(cpu));
+    }
+    if (*p == ',') ++p;
+  }
+  return cpus;
+}
+
+std::vector<unsigned> read_cpulist(const std::string& path) {
+  std::FILE* f = fopen(path.c_str(), "r");
+  if (f == nullptr) return {};
+  char buf[4096];
+  size_t n = fread(buf, 1, sizeof(buf) - 1, f);
+  fclose(f);
+  buf[n] = '\0';
+  return parse_cpulist(buf);
+}
+
+}  // namespace
+
+NumaTopology::NumaTopology() {
+  // Nodes are dense in practice but probe a generous range anyway;
+  // a missing nodeN directory after a hit means we are done.
+  for (unsigned id = 0; id < 1024; ++id) {
+    char path[64];
+    std::snprintf(path, sizeof(path),
+                  "/sys/devices/system/node/node%u/cpulist", id);
+    std::vector<unsigned> cpus = read_cpulist(path);
+    if (cpus.empty()) {
+      if (!nodes_.empty()) break;
+      continue;  // node0 can be absent on some containers
+    }
+    nodes_.push_back({id, std::move(cpus)});
+  }
+  if (nodes_.empty()) {
+    // No sysfs hierarchy: one node owning every online CPU.
+    NumaNode node;
+    long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+    for (long cpu = 0; cpu < std::max(1L, cpu_count); ++cpu) {
+      node.cpus.push_back(static_cast<unsigned>(cpu));
+    }
+    nodes_.push_back(std::move(node));
+  }
+}
+
+const NumaTopology& NumaTopology::get() {
+  static const NumaTopology topology;
+  return topology;
+}
+
+bool NumaTopology::pin_current_thread(const NumaNode& node) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (unsigned cpu : node.cpus) CPU_SET(cpu, &set);
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+void NumaTopology::first_touch(void* p, size_t bytes) {
+  static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  volatile char* bytes_p = static_cast<volatile char*>(p);
+  for (size_t off = 0; off < bytes; off += page) {
+    bytes_p[off] = bytes_p[off];
+  }
+}
+
+}  // namespace proga::sched
@@ -0,0 +1,55 @@
+#pragma once
+
+// NUMA topology discovery and worker placement.
+//
+// Topology is read from /sys/devices/system/node (no libnuma
+// dependency); machines without the hierarchy present as one node
+// holding every CPU, so callers size themselves off node_count()
+// unconditionally. Placement relies on two primitives: pinning a
+// worker to its node's CPU set, and first-touch — Linux backs a page
+// on the node of the thread that first writes it, so a pinned worker
+// that touches its own buffers and mmap chunk gets node-local memory
+// without explicit page migration.
+
+#include <cstddef>
+#include <vector>
+
+namespace proga::sched {
+
+struct NumaNode {
+  unsigned id = 0;
+  std::vector<unsigned> cpus;
+};
+
+class NumaTopology {
+ public:
+  // Reads the sysfs node hierarchy once. Always yields at least one
+  // node; a UMA box is node 0 with all online CPUs.
+  static const NumaTopology& get();
+
+  size_t node_count() const { return nodes_.size(); }
+  const std::vector<NumaNode>& nodes() const { return nodes_; }
+
+  // The node a worker index maps to when spreading workers
+  // round-robin across the machine.
+  const NumaNode& node_for_worker(size_t worker_index) const {
+    return nodes_[worker_index % nodes_.size()];
+  }
+
+  // Restricts the calling thread to `node`'s CPUs. Returns false when
+  // the kernel refuses (e.g. an external cpuset already excludes
+  // them); the caller keeps running unpinned.
+  static bool pin_current_thread(const NumaNode& node);
+
+  // Writes one byte per page so the pages are faulted in — and placed
+  // — on the calling thread's node. Call after pinning, before
+  // handing the buffer to the hot path.
+  static void first_touch(void* p, size_t bytes);
+
+ private:
+  NumaTopology();
+
+  std::vector<NumaNode> nodes_;
+};
+
+}  // namespace proga::sched
@@ -0,0 +1,161 @@
+#include "sched/work_stealing.h"
+
+#include <chrono>
+
+#include "sched/numa.h"
+
+namespace proga::sched {
+
+namespace {
+
+constexpr size_t kDequeCapacity = 8192;
+constexpr size_t kInjectCapacity = 4096;
+
+// Which worker (if any) the current thread is; routes nested submits.
+thread_local WorkStealingPool* tls_pool = nullptr;
+thread_local unsigned tls_worker = 0;
+
+}  // namespace
+
+// Chase-Lev deque (Le/Pop/Cohen/Nardelli memory orders).
+WorkStealingPool::Deque::Deque(size_t capacity) {
+  size_t cap = 2;
+  while (cap < capacity) cap <<= 1;
+  mask_ = cap - 1;
+  buffer_ = std::make_unique<std::atomic<Task*>[]>(cap);
+}
+
+bool WorkStealingPool::Deque::push(Task* task) {
+  intptr_t b = bottom_.load(std::memory_order_relaxed);
+  intptr_t t = top_.load(std::memory_order_acquire);
+  if (b - t > static_cast<intptr_t>(mask_)) return false;  // full
+  buffer_[b & mask_].store(task, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  bottom_.store(b + 1, std::memory_order_relaxed);
+  return true;
+}
+
+WorkStealingPool::Task* WorkStealingPool::Deque::pop() {
+  intptr_t b = bottom_.load(std::memory_order_relaxed) - 1;
+  bottom_.store(b, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  intptr_t t = top_.load(std::memory_order_relaxed);
+  if (t > b) {
+    bottom_.store(b + 1, std::memory_order_relaxed);
+    return nullptr;  // empty
+  }
+  Task* task = buffer_[b & mask_].load(std::memory_order_relaxed);
+  if (t == b) {
+    // Last element: race against thieves for it.
+    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      task = nullptr;  // a thief won
+    }
+    bottom_.store(b + 1, std::memory_order_relaxed);
+  }
+  return task;
+}
+
+WorkStealingPool::Task* WorkStealingPool::Deque::steal() {
+  intptr_t t = top_.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  intptr_t b = bottom_.load(std::memory_order_acquire);
+  if (t >= b) return nullptr;  // empty
+  Task* task = buffer_[t & mask_].load(std::memory_order_relaxed);
+  if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                    std::memory_order_relaxed)) {
+    return nullptr;  // lost the race
+  }
+  return task;
+}
+
+WorkStealingPool::WorkStealingPool(unsigned num_threads)
+    : inject_(kInjectCapacity) {
+  if (num_threads == 0) {
+    num_threads = std::thread::hardware_concurrency();
+    if (num_threads == 0) num_threads = 1;
+  }
+  for (unsigned i = 0; i < num_threads; ++i) {
+    workers_.push_back(std::make_unique<Worker>(kDequeCapacity));
+  }
+  for (unsigned i = 0; i < num_threads; ++i) {
+    workers_[i]->thread = std::thread([this, i] { worker_loop(i); });
+  }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  wait_idle();
+  stop_.store(true, std::memory_order_relaxed);
+  idle_cv_.notify_all();
+  for (auto& w : workers_) {
+    if (w->thread.joinable()) w->thread.join();
+  }
+}
+
+void WorkStealingPool::submit(Task task) {
+  Task* heap_task = new Task(std::move(task));
+  pending_.fetch_add(1, std::memory_order_relaxed);
+  if (tls_pool == this) {
+    // Spawned from inside a task: prefer the owner's deque.
+    if (workers_[tls_worker]->deque.push(heap_task)) {
+      idle_cv_.notify_one();
+      return;
+    }
+  }
+  while (!inject_.try_push(std::move(heap_task))) {
+    // Inject queue full: helping is not an option off-pool, so yield.
+    std::this_thread::yield();
+  }
+  idle_cv_.notify_one();
+}
+
+WorkStealingPool::Task* WorkStealingPool::find_task(unsigned self) {
+  if (Task* task = workers_[self]->deque.pop()) return task;
+  Task* task = nullptr;
+  if (inject_.try_pop(task)) return task;
+  // Steal sweep starting after ourselves, so victims differ per worker.
+  for (size_t i = 1; i < workers_.size(); ++i) {
+    unsigned victim = (self + i) % workers_.size();
+    if ((task = workers_[victim]->deque.steal()) != nullptr) return task;
+  }
+  return nullptr;
+}
+
+void WorkStealingPool::run(Task* task) {
+  (*task)();
+  delete task;
+  if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    std::lock_guard<std::mutex> lock(idle_mu_);
+    drained_cv_.notify_all();
+  }
+}
+
+void WorkStealingPool::worker_loop(unsigned index) {
+  tls_pool = this;
+  tls_worker = index;
+  // On multi-socket machines workers spread over NUMA nodes, keeping
+  // steals mostly node-local (victim order is index-adjacent).
+  const NumaTopology& topology = NumaTopology::get();
+  if (topology.node_count() > 1) {
+    NumaTopology::pin_current_thread(topology.node_for_worker(index));
+  }
+  while (!stop_.load(std::memory_order_relaxed)) {
+    if (Task* task = find_task(index)) {
+      run(task);
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(idle_mu_);
+    if (stop_.load(std::memory_order_relaxed)) break;
+    if (pending_.load(std::memory_order_relaxed) > 0) continue;  // recheck
+    idle_cv_.wait_for(lock, std::chrono::milliseconds(10));
+  }
+}
+
+void WorkStealingPool::wait_idle() {
+  std::unique_lock<std::mutex> lock(idle_mu_);
+  drained_cv_.wait(lock, [this] {
+    return pending_.load(std::memory_order_acquire) == 0;
+  });
+}
+
+}  // namespace proga::sched
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "concurrency/mpmc_queue.h"
+
+namespace proga::sched {
+
+// Work-stealing task pool for per-record processing with skewed costs.
+// Each worker owns a Chase-Lev deque: it pushes and pops at the bottom
+// without contention, while idle workers steal single tasks from the
+// top. Tasks submitted from outside the pool land in a shared inject
+// queue; tasks spawned by a running task go straight onto that
+// worker's own deque, which keeps hot paths contention-free and lets
+// an expensive record's continuations be stolen by idle cores.
+class WorkStealingPool {
+ public:
+  using Task = std::function<void()>;
+
+  // 0 means one worker per hardware thread.
+  explicit WorkStealingPool(unsigned num_threads = 0);
+  ~WorkStealingPool();
+
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+  // Schedules a task. Callable from any thread, including from inside
+  // a running task.
+  void submit(Task task);
+
+  // Blocks until every submitted task (including ones spawned by
+  // running tasks) has finished.
+  void wait_idle();
+
+  unsigned worker_count() const { return static_cast<unsigned>(workers_.size()); }
+
+ private:
+  // Chase-Lev deque of owned task pointers. Bounded; push reports
+  // failure when full and the caller reroutes to the inject queue.
+  class Deque {
+   public:
+    explicit Deque(size_t capacity);
+    bool push(Task* task);   // owner only
+    Task* pop();             // owner only
+    Task* steal();           // any thread
+   private:
+    std::unique_ptr<std::atomic<Task*>[]> buffer_;
+    size_t mask_;
+    alignas(64) std::atomic<intptr_t> top_{0};
+    alignas(64) std::atomic<intptr_t> bottom_{0};
+  };
+
+  struct Worker {
+    explicit Worker(size_t deque_capacity) : deque(deque_capacity) {}
+    Deque deque;
+    std::thread thread;
+  };
+
+  void worker_loop(unsigned index);
+  void run(Task* task);
+  Task* find_task(unsigned self);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  concurrency::MpmcQueue<Task*> inject_;
+  std::atomic<size_t> pending_{0};
+  std::atomic<bool> stop_{false};
+  std::mutex idle_mu_;
+  std::condition_variable idle_cv_;   // work arrived
+  std::condition_variable drained_cv_;  // pending_ hit zero
+};
+
+}  // namespace proga::sched
@@ -0,0 +1,66 @@
+#pragma once
+
+// Little-endian put/get helpers for the binary artifact formats
+// (snapshots, sketch state). Writers append to a byte vector; readers
+// walk a bounds-checked cursor and report truncation instead of
+// reading past the end.
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+namespace proga::util {
+
+inline void put_bytes(std::vector<uint8_t>& out, const void* p, size_t n) {
+  size_t old_size = out.size();
+  out.resize(old_size + n);
+  memcpy(out.data() + old_size, p, n);
+}
+
+inline void put_u32(std::vector<uint8_t>& out, uint32_t v) {
+  put_bytes(out, &v, sizeof(v));
+}
+
+inline void put_u64(std::vector<uint8_t>& out, uint64_t v) {
+  put_bytes(out, &v, sizeof(v));
+}
+
+inline void put_string(std::vector<uint8_t>& out, std::string_view s) {
+  put_u32(out, static_cast<uint32_t>(s.size()));
+  put_bytes(out, s.data(), s.size());
+}
+
+class BinaryCursor {
+ public:
+  BinaryCursor(const uint8_t* p, size_t n) : p_(p), end_(p + n) {}
+
+  bool get_u32(uint32_t& v) { return get(&v, sizeof(v)); }
+  bool get_u64(uint64_t& v) { return get(&v, sizeof(v)); }
+  bool get_bytes(void* dst, size_t n) { return get(dst, n); }
+
+  // Returns a view into the underlying buffer; valid while it lives.
+  bool get_string(std::string_view& s) {
+    uint32_t len = 0;
+    if (!get_u32(len) || remaining() < len) return false;
+    s = std::string_view(reinterpret_cast<const char*>(p_), len);
+    p_ += len;
+    return true;
+  }
+
+  size_t remaining() const { return static_cast<size_t>(end_ - p_); }
+  bool done() const { return p_ == end_; }
+
+ private:
+  bool get(void* dst, size_t n) {
+    if (remaining() < n) return false;
+    memcpy(dst, p_, n);
+    p_ += n;
+    return true;
+  }
+
+  const uint8_t* p_;
+  const uint8_t* end_;
+};
+
+}  // namespace proga::util
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace proga::util {
+
+// xxHash64 (Collet). Used wherever a fast, well-mixed 64-bit content
+// hash is needed: sketch inputs, dedup fingerprints. Not a
+// cryptographic hash.
+inline uint64_t xxhash64(const void* data, size_t len, uint64_t seed = 0) {
+  constexpr uint64_t kP1 = 0x9e3779b185ebca87ull;
+  constexpr uint64_t kP2 = 0xc2b2ae3d27d4eb4full;
+  constexpr uint64_t kP3 = 0x165667b19e3779f9ull;
+  constexpr uint64_t kP4 = 0x85ebca77c2b2ae63ull;
+  constexpr uint64_t kP5 = 0x27d4eb2f165667c5ull;
+
+  auto rotl = [](uint64_t x, int r) { return (x << r) | (x >> (64 - r)); };
+  auto read64 = [](const uint8_t* p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+  };
+  auto read32 = [](const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+  };
+  auto round = [&](uint64_t acc, uint64_t input) {
+    return rotl(acc + input * kP2, 31) * kP1;
+  };
+
+  const uint8_t* p = static_cast<const uint8_t*>(data);
+  const uint8_t* end = p + len;
+  uint64_t h;
+  if (len >= 32) {
+    uint64_t v1 = seed + kP1 + kP2;
+    uint64_t v2 = seed + kP2;
+    uint64_t v3 = seed;
+    uint64_t v4 = seed - kP1;
+    do {
+      v1 = round(v1, read64(p));
+      v2 = round(v2, read64(p + 8));
+      v3 = round(v3, read64(p + 16));
+      v4 = round(v4, read64(p + 24));
+      p += 32;
+    } while (p + 32 <= end);
+    h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+    auto merge = [&](uint64_t acc, uint64_t v) {
+      return (acc ^ round(0, v)) * kP1 + kP4;
+    };
+    h = merge(h, v1);
+    h = merge(h, v2);
+    h = merge(h, v3);
+    h = merge(h, v4);
+  } else {
+    h = seed + kP5;
+  }
+  h += len;
+  while (p + 8 <= end) {
+    h = rotl(h ^ round(0, read64(p)), 27) * kP1 + kP4;
+    p += 8;
+  }
+  if (p + 4 <= end) {
+    h = rotl(h ^ (uint64_t(read32(p)) * kP1), 23) * kP2 + kP3;
+    p += 4;
+  }
+  while (p < end) {
+    h = rotl(h ^ (*p * kP5), 11) * kP1;
+    ++p;
+  }
+  h ^= h >> 33;
+  h *= kP2;
+  h ^= h >> 29;
+  h *= kP3;
+  h ^= h >> 32;
+  return h;
+}
+
+inline uint64_t xxhash64(std::string_view s, uint64_t seed = 0) {
+  return xxhash64(s.data(), s.size(), seed);
+}
+
+}  // namespace proga::util
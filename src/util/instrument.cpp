@@ -0,0 +1,142 @@
+#include "util/instrument.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace proga::util {
+
+#if !(defined(__x86_64__) || defined(__i386__) || defined(__aarch64__))
+uint64_t cycle_now() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+#endif
+
+namespace {
+
+struct Registry {
+  std::mutex mutex;
+  std::vector<std::unique_ptr<Stage>> stages;
+};
+
+Registry& registry() {
+  static Registry r;
+  return r;
+}
+
+// Percentile from the log2 histogram: walk the cumulative counts and
+// take the geometric midpoint of the bucket that crosses the rank.
+double percentile_cycles(const Stage& stage, double q) {
+  uint64_t total = stage.count.load(std::memory_order_relaxed);
+  if (total == 0) return 0;
+  uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total - 1));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < Stage::kBuckets; ++i) {
+    seen += stage.histogram[i].load(std::memory_order_relaxed);
+    if (seen > rank) {
+      double lo = std::ldexp(1.0, static_cast<int>(i));
+      return lo * 1.5;  // midpoint of [2^i, 2^(i+1))
+    }
+  }
+  return 0;
+}
+
+}  // namespace
+
+Stage& Instrumentation::stage(std::string_view name) {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  for (auto& s : r.stages) {
+    if (s->name == name) return *s;
+  }
+  r.stages.push_back(std::make_unique<Stage>(std::string(name)));
+  return *r.stages.back();
+}
+
+double Instrumentation::cycles_per_ns() {
+  static const double calibrated = [] {
+    // Pin cycle_now() to wall time over a short sleep. cntvct and
+    // modern TSCs are constant-rate, so one calibration holds.
+    auto wall_start = std::chrono::steady_clock::now();
+    uint64_t cycle_start = cycle_now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    uint64_t cycle_elapsed = cycle_now() - cycle_start;
+    auto wall_elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - wall_start)
+                            .count();
+    if (wall_elapsed <= 0 || cycle_elapsed == 0) return 1.0;
+    return static_cast<double>(cycle_elapsed) /
+           static_cast<double>(wall_elapsed);
+  }();
+  return calibrated;
+}
+
+std::string Instrumentation::snapshot_json() {
+  double scale = cycles_per_ns();
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  std::string out = "{\"stages\":[";
+  char line[256];
+  bool first = true;
+  for (const auto& s : r.stages) {
+    uint64_t count = s->count.load(std::memory_order_relaxed);
+    double ns_total =
+        static_cast<double>(s->cycles.load(std::memory_order_relaxed)) / scale;
+    std::snprintf(line, sizeof(line),
+                  "%s{\"name\":\"%s\",\"count\":%llu,\"ns_total\":%.0f,"
+                  "\"ns_op\":%.1f,\"p50_ns\":%.0f,\"p99_ns\":%.0f}",
+                  first ? "" : ",", s->name.c_str(),
+                  static_cast<unsigned long long>(count), ns_total,
+                  count == 0 ? 0.0 : ns_total / static_cast<double>(count),
+                  percentile_cycles(*s, 0.50) / scale,
+                  percentile_cycles(*s, 0.99) / scale);
+    out += line;
+    first = false;
+  }
+  out += "]}";
+  return out;
+}
+
+std::string Instrumentation::summary() {
+  double scale = cycles_per_ns();
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  std::string out;
+  char line[256];
+  for (const auto& s : r.stages) {
+    uint64_t count = s->count.load(std::memory_order_relaxed);
+    if (count == 0) continue;
+    double ns_total =
+        static_cast<double>(s->cycles.load(std::memory_order_relaxed)) / scale;
+    std::snprintf(line, sizeof(line),
+                  "bench name=stage.%s ns_op=%.1f p50_ns=%.0f p99_ns=%.0f "
+                  "reps=%llu\n",
+                  s->name.c_str(), ns_total / static_cast<double>(count),
+                  percentile_cycles(*s, 0.50) / scale,
+                  percentile_cycles(*s, 0.99) / scale,
+                  static_cast<unsigned long long>(count));
+    out += line;
+  }
+  return out;
+}
+
+void Instrumentation::reset() {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  for (auto& s : r.stages) {
+    s->count.store(0, std::memory_order_relaxed);
+    s->cycles.store(0, std::memory_order_relaxed);
+    for (auto& bucket : s->histogram) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+}  // namespace proga::util
@@ -0,0 +1,111 @@
+#pragma once
+
+// Built-in hot-path instrumentation.
+//
+// PROGA_TIMED_SCOPE("stage.name") drops an rdtsc-based timer into a
+// scope; each stage accumulates a call count, total cycles, and a
+// log2-bucket cycle histogram (lock-free, a few ns per sample).
+// Instrumentation::snapshot_json() exports everything as JSON;
+// summary() renders the same data as bench_output.txt-style lines so
+// existing tooling can ingest per-stage ns/record from production.
+//
+// The PROGA_INSTRUMENT compile definition (CMake option of the same
+// name, on by default) gates every probe; when it is off the macro
+// expands to nothing and the hot paths carry zero cost.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace proga::util {
+
+#if defined(__x86_64__) || defined(__i386__)
+inline uint64_t cycle_now() { return __builtin_ia32_rdtsc(); }
+#elif defined(__aarch64__)
+inline uint64_t cycle_now() {
+  uint64_t v;
+  asm volatile("mrs %0, cntvct_el0" : "=r"(v));
+  return v;
+}
+#else
+uint64_t cycle_now();  // steady_clock fallback, cycles == ns
+#endif
+
+// Accumulator for one named stage. Shared across threads; every member
+// is updated with relaxed atomics since only aggregate totals matter.
+struct Stage {
+  static constexpr size_t kBuckets = 64;  // bucket i holds [2^i, 2^(i+1))
+
+  const std::string name;
+  std::atomic<uint64_t> count{0};
+  std::atomic<uint64_t> cycles{0};
+  std::atomic<uint64_t> histogram[kBuckets] = {};
+
+  explicit Stage(std::string stage_name) : name(std::move(stage_name)) {}
+
+  void record(uint64_t elapsed_cycles) {
+    count.fetch_add(1, std::memory_order_relaxed);
+    cycles.fetch_add(elapsed_cycles, std::memory_order_relaxed);
+    size_t bucket =
+        elapsed_cycles == 0 ? 0 : 63 - __builtin_clzll(elapsed_cycles);
+    histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+  }
+};
+
+class Instrumentation {
+ public:
+  // Registers (or returns the existing) stage under `name`. The
+  // reference stays valid for the process lifetime; call sites cache
+  // it in a function-local static so the hot path never takes the
+  // registry lock.
+  static Stage& stage(std::string_view name);
+
+  // Cycles per nanosecond of the cycle counter, calibrated against
+  // steady_clock on first use.
+  static double cycles_per_ns();
+
+  // {"stages":[{"name":...,"count":...,"ns_total":...,"ns_op":...,
+  //             "p50_ns":...,"p99_ns":...}, ...]}
+  static std::string snapshot_json();
+
+  // One bench_output.txt-compatible line per stage:
+  //   bench name=stage.<name> ns_op=... p50_ns=... p99_ns=... reps=...
+  static std::string summary();
+
+  // Zeroes every stage (names stay registered).
+  static void reset();
+};
+
+// RAII probe used by PROGA_TIMED_SCOPE.
+class ScopedTimer {
+ public:
+  explicit ScopedTimer(Stage& stage) : stage_(stage), start_(cycle_now()) {}
+  ~ScopedTimer() { stage_.record(cycle_now() - start_); }
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+ private:
+  Stage& stage_;
+  uint64_t start_;
+};
+
+}  // namespace proga::util
+
+#if defined(PROGA_INSTRUMENT)
+#define PROGA_TIMED_SCOPE_CAT2(a, b) a##b
+#define PROGA_TIMED_SCOPE_CAT(a, b) PROGA_TIMED_SCOPE_CAT2(a, b)
+#define PROGA_TIMED_SCOPE(stage_name)                                   \
+  static ::proga::util::Stage& PROGA_TIMED_SCOPE_CAT(proga_stage_,      \
+                                                     __LINE__) =        \
+      ::proga::util::Instrumentation::stage(stage_name);                \
+  ::proga::util::ScopedTimer PROGA_TIMED_SCOPE_CAT(proga_timer_,        \
+                                                   __LINE__)(           \
+      PROGA_TIMED_SCOPE_CAT(proga_stage_, __LINE__))
+#else
+#define PROGA_TIMED_SCOPE(stage_name) \
+  do {                                \
+  } while (false)
+#endif
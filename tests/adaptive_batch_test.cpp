@@ -0,0 +1,97 @@
+#include "pipeline/adaptive_batch.h"
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include "framework.h"
+#include "pipeline/coro_reader.h"
+
+using namespace proga;
+
+TEST(adaptive_batcher_shrinks_when_latency_overshoots) {
+  pipeline::AdaptiveBatcher::Options options;
+  options.target_p99_ms = 5.0;
+  options.adjust_every = 8;
+  options.initial_batch = 256;
+  pipeline::AdaptiveBatcher batcher(options);
+  CHECK_EQ(batcher.batch_size(), 256u);
+
+  // Every batch lands way over the 5 ms target.
+  for (int i = 0; i < 200; ++i) {
+    batcher.on_batch(batcher.batch_size(), 50u * 1000 * 1000);
+  }
+  CHECK_EQ(batcher.batch_size(), options.min_batch);
+  CHECK(batcher.stats().p99_ms > 5.0);
+}
+
+TEST(adaptive_batcher_grows_under_fast_replay) {
+  pipeline::AdaptiveBatcher::Options options;
+  options.target_p99_ms = 5.0;
+  options.adjust_every = 8;
+  options.initial_batch = 4;
+  options.max_batch = 1024;
+  pipeline::AdaptiveBatcher batcher(options);
+
+  // Microsecond deliveries at replay arrival rates: probe upward to
+  // the cap.
+  for (int i = 0; i < 500; ++i) {
+    batcher.on_batch(batcher.batch_size(), 1000);
+  }
+  CHECK_EQ(batcher.batch_size(), 1024u);
+  CHECK_EQ(batcher.stats().batches, 500u);
+}
+
+TEST(adaptive_batcher_caps_at_arrival_rate_budget) {
+  pipeline::AdaptiveBatcher::Options options;
+  options.target_p99_ms = 10.0;
+  options.adjust_every = 4;
+  options.initial_batch = 256;
+  pipeline::AdaptiveBatcher batcher(options);
+
+  // A trickle: one record every ~5 ms, delivered promptly. Fast
+  // deliveries alone would grow the batch, but the arrival rate only
+  // supports a couple of records per 10 ms budget.
+  for (int i = 0; i < 12; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    batcher.on_batch(1, 100 * 1000);
+  }
+  CHECK(batcher.batch_size() <= 8);
+  CHECK(batcher.stats().arrival_rate < 1000);
+}
+
+TEST(adaptive_stream_delivers_everything_with_bounded_batches) {
+  const char* path = "adaptive_stream.jsonl";
+  std::FILE* f = std::fopen(path, "w");
+  for (int i = 0; i < 5000; ++i) std::fprintf(f, "{\"seq\":%d}\n", i);
+  std::fclose(f);
+
+  pipeline::CoroExecutor executor(1);
+  pipeline::JsonlStream::Options options;
+  options.follow = false;
+  options.adaptive = true;
+  options.max_batch_records = 512;
+  auto stream = pipeline::JsonlStream::open(executor, path, options);
+  CHECK(stream.has_value());
+  CHECK(stream->current_batch_size() <= 512);
+  CHECK(stream->current_batch_size() >= 1);
+
+  struct Drain {
+    static pipeline::CoroTask run(pipeline::JsonlStream& stream,
+                                  uint64_t& records) {
+      for (;;) {
+        auto batch = co_await stream.next_batch();
+        records += batch.records.size();
+        if (batch.end_of_stream) co_return;
+      }
+    }
+  };
+  uint64_t records = 0;
+  executor.spawn(Drain::run(*stream, records));
+  executor.wait_idle();
+  CHECK_EQ(records, 5000u);
+  CHECK_EQ(stream->records_delivered(), 5000u);
+  CHECK(stream->current_batch_size() >= 1);
+  CHECK(stream->current_batch_size() <= 512);
+  std::remove(path);
+}
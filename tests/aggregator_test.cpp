@@ -0,0 +1,85 @@
+#include "agg/aggregator.h"
+
+#include <cmath>
+#include <cstdio>
+
+#include "framework.h"
+#include "jsonl/mmap_reader.h"
+
+using namespace proga;
+
+TEST(ddsketch_quantiles_within_relative_error) {
+  agg::DDSketch sketch(0.01);
+  for (int i = 1; i <= 10000; ++i) sketch.add(i);
+  CHECK_EQ(sketch.count(), 10000u);
+  double p50 = sketch.quantile(0.50);
+  double p99 = sketch.quantile(0.99);
+  CHECK(std::fabs(p50 - 5000) / 5000 < 0.02);
+  CHECK(std::fabs(p99 - 9900) / 9900 < 0.02);
+}
+
+TEST(hyperloglog_estimates_distincts) {
+  agg::HyperLogLog hll;
+  char buf[32];
+  for (int i = 0; i < 50000; ++i) {
+    std::snprintf(buf, sizeof(buf), "user-%d", i % 10000);
+    hll.add(buf);
+  }
+  double est = hll.estimate();
+  CHECK(std::fabs(est - 10000) / 10000 < 0.05);
+
+  // Merge equals union.
+  agg::HyperLogLog a, b;
+  a.add("x");
+  a.add("y");
+  b.add("y");
+  b.add("z");
+  a.merge(b);
+  CHECK(std::fabs(a.estimate() - 3) < 0.5);
+}
+
+TEST(aggregator_one_pass_over_log) {
+  const char* path = "agg_test.jsonl";
+  std::FILE* f = std::fopen(path, "w");
+  for (int i = 0; i < 9000; ++i) {
+    std::fprintf(f,
+                 "{\"url\":\"/e/%d\",\"latency_ms\":%d,\"user\":\"u%d\"}\n",
+                 i % 3, (i % 3 + 1) * 100, i % 50);
+  }
+  std::fclose(f);
+
+  auto reader = jsonl::JsonlMmapReader::open(path);
+  agg::Aggregator agg({"url", "latency_ms", "user"});
+  jsonl::RecordView rec;
+  while (reader->next(rec)) agg.add(rec);
+
+  CHECK_EQ(agg.records_seen(), 9000u);
+  CHECK_EQ(agg.group_count(), 3u);
+  for (const auto& g : agg.results()) {
+    CHECK_EQ(g.count, 3000u);
+    int endpoint = g.key.back() - '0';
+    double expected_latency = (endpoint + 1) * 100;
+    CHECK(std::fabs(g.p50 - expected_latency) / expected_latency < 0.03);
+    CHECK(std::fabs(g.distinct - 50) < 3);
+  }
+  std::remove(path);
+}
+
+TEST(aggregator_merge_matches_single_pass) {
+  agg::Aggregator a({"m", "v", ""});
+  agg::Aggregator b({"m", "v", ""});
+  jsonl::RecordView r1("{\"m\":\"GET\",\"v\":10}");
+  jsonl::RecordView r2("{\"m\":\"GET\",\"v\":30}");
+  jsonl::RecordView r3("{\"m\":\"PUT\",\"v\":20}");
+  a.add(r1);
+  b.add(r2);
+  b.add(r3);
+  a.merge(b);
+  CHECK_EQ(a.records_seen(), 3u);
+  CHECK_EQ(a.group_count(), 2u);
+  auto results = a.results();
+  for (const auto& g : results) {
+    if (g.key == "GET") CHECK_EQ(g.count, 2u);
+    if (g.key == "PUT") CHECK_EQ(g.count, 1u);
+  }
+}
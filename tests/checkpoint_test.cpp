@@ -0,0 +1,128 @@
+#include "pipeline/checkpoint.h"
+
+#include <cmath>
+#include <cstdio>
+
+#include "framework.h"
+#include "jsonl/mmap_reader.h"
+
+using namespace proga;
+
+namespace {
+
+agg::Aggregator::Options agg_options() {
+  return {"url", "latency_ms", "user"};
+}
+
+void write_log(const char* path, int records) {
+  std::FILE* f = std::fopen(path, "w");
+  for (int i = 0; i < records; ++i) {
+    std::fprintf(f,
+                 "{\"url\":\"/e/%d\",\"latency_ms\":%d,\"user\":\"u%d\"}\n",
+                 i % 3, (i % 3 + 1) * 100, i % 40);
+  }
+  std::fclose(f);
+}
+
+}  // namespace
+
+TEST(checkpoint_round_trips_offsets_and_aggregation) {
+  const char* log = "ckpt_test.jsonl";
+  const char* snap = "ckpt_test.snapshot";
+  write_log(log, 6000);
+
+  agg::Aggregator agg(agg_options());
+  auto reader = jsonl::JsonlMmapReader::open(log);
+  CHECK(reader.has_value());
+  jsonl::RecordView rec;
+  while (reader->next(rec)) agg.add(rec);
+  CHECK(pipeline::Checkpoint::save(snap, {123, 456}, &agg));
+
+  std::vector<uint64_t> offsets;
+  agg::Aggregator restored(agg_options());
+  CHECK(pipeline::Checkpoint::load(snap, offsets, &restored));
+  CHECK_EQ(offsets.size(), 2u);
+  CHECK_EQ(offsets[0], 123u);
+  CHECK_EQ(offsets[1], 456u);
+  CHECK_EQ(restored.records_seen(), 6000u);
+  CHECK_EQ(restored.group_count(), 3u);
+  auto before = agg.results();
+  auto after = restored.results();
+  for (size_t i = 0; i < before.size(); ++i) {
+    CHECK_EQ(after[i].key, before[i].key);
+    CHECK_EQ(after[i].count, before[i].count);
+    CHECK(std::fabs(after[i].p50 - before[i].p50) < 1e-9);
+    CHECK(std::fabs(after[i].distinct - before[i].distinct) < 1e-9);
+  }
+  std::remove(log);
+  std::remove(snap);
+}
+
+TEST(checkpoint_resume_continues_where_it_stopped) {
+  const char* log = "ckpt_resume.jsonl";
+  const char* snap = "ckpt_resume.snapshot";
+  write_log(log, 9000);
+
+  // First run dies halfway, after checkpointing its position.
+  {
+    agg::Aggregator agg(agg_options());
+    auto reader = jsonl::JsonlMmapReader::open(log);
+    jsonl::RecordView rec;
+    size_t seen = 0;
+    uint64_t consumed = 0;
+    while (seen < 4500 && reader->next(rec)) {
+      agg.add(rec);
+      ++seen;
+      consumed = reader->bytes_consumed();
+    }
+    CHECK(pipeline::Checkpoint::save(snap, {consumed}, &agg));
+  }
+
+  // Second run restores and replays only the tail.
+  std::vector<uint64_t> offsets;
+  agg::Aggregator agg(agg_options());
+  CHECK(pipeline::Checkpoint::load(snap, offsets, &agg));
+  CHECK_EQ(agg.records_seen(), 4500u);
+  auto file = io::MmapFile::open(log);
+  CHECK(file.has_value());
+  jsonl::JsonlReader tail(file->view().substr(offsets[0]));
+  jsonl::RecordView rec;
+  while (tail.next(rec)) agg.add(rec);
+
+  CHECK_EQ(agg.records_seen(), 9000u);
+  for (const auto& g : agg.results()) CHECK_EQ(g.count, 3000u);
+  std::remove(log);
+  std::remove(snap);
+}
+
+TEST(checkpoint_writer_rate_limits_and_flushes) {
+  const char* snap = "ckpt_writer.snapshot";
+  {
+    pipeline::CheckpointWriter::Options options;
+    options.interval_ms = 100000;  // only the first snapshot passes
+    auto writer = pipeline::CheckpointWriter::open(snap, options);
+    CHECK(writer.has_value());
+    CHECK(writer->maybe_checkpoint({1}, nullptr));
+    CHECK(!writer->maybe_checkpoint({2}, nullptr));  // inside the interval
+    CHECK(writer->checkpoint_now({3}, nullptr));     // forced
+    CHECK(writer->flush());
+    CHECK(writer->snapshots_written() >= 1);
+  }
+  std::vector<uint64_t> offsets;
+  CHECK(pipeline::Checkpoint::load(snap, offsets, nullptr));
+  CHECK_EQ(offsets.size(), 1u);
+  CHECK_EQ(offsets[0], 3u);  // the newest snapshot wins
+  std::remove(snap);
+}
+
+TEST(checkpoint_rejects_corrupt_snapshots) {
+  const char* snap = "ckpt_bad.snapshot";
+  std::FILE* f = std::fopen(snap, "wb");
+  std::fwrite("NOTASNAP", 1, 8, f);
+  std::fclose(f);
+  std::vector<uint64_t> offsets;
+  CHECK(!pipeline::Checkpoint::load(snap, offsets, nullptr));
+  CHECK(!pipeline::Checkpoint::load("ckpt_missing.snapshot", offsets,
+                                    nullptr));
+  std::remove(snap);
+}
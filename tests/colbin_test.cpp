@@ -0,0 +1,115 @@
+#include "colbin/colbin.h"
+
+#include <cstdio>
+
+#include "framework.h"
+
+using namespace proga::colbin;
+
+TEST(colbin_round_trip) {
+  const char* log = "colbin_test.jsonl";
+  const char* sidecar = "colbin_test.colbin";
+  std::FILE* f = std::fopen(log, "w");
+  CHECK(f != nullptr);
+  std::fprintf(f, "{\"method\":\"GET\",\"latency_ms\":12,\"score\":0.5}\n");
+  std::fprintf(f, "{\"method\":\"POST\",\"latency_ms\":450}\n");
+  std::fprintf(f, "{\"method\":\"GET\",\"latency_ms\":7,\"score\":1.25}\n");
+  std::fclose(f);
+
+  CHECK(compile(log, sidecar));
+  auto reader = ColbinReader::open(sidecar);
+  CHECK(reader.has_value());
+  CHECK_EQ(reader->record_count(), 3u);
+  CHECK_EQ(reader->column_count(), 3u);
+
+  auto method = reader->column("method");
+  CHECK(method.has_value());
+  CHECK(method->type() == ColumnType::kString);
+  CHECK_EQ(method->string_at(0), "GET");
+  CHECK_EQ(method->string_at(1), "POST");
+  CHECK_EQ(method->string_at(2), "GET");
+  // Repeated values share one dictionary entry.
+  CHECK_EQ(method->dict_size(), 2u);
+  CHECK_EQ(method->codes()[0], method->codes()[2]);
+
+  auto latency = reader->column("latency_ms");
+  CHECK(latency.has_value());
+  CHECK(latency->type() == ColumnType::kInt64);
+  CHECK_EQ(latency->int64s()[1], 450);
+
+  auto score = reader->column("score");
+  CHECK(score.has_value());
+  CHECK(score->type() == ColumnType::kFloat64);
+  CHECK_EQ(score->float64s()[2], 1.25);
+  CHECK(!score->is_null(0));
+  CHECK(score->is_null(1));  // absent on record 1
+
+  CHECK(!reader->column("missing").has_value());
+  std::remove(log);
+  std::remove(sidecar);
+}
+
+TEST(colbin_rejects_corrupt_file) {
+  const char* path = "colbin_bad.colbin";
+  std::FILE* f = std::fopen(path, "w");
+  std::fprintf(f, "not a colbin file at all");
+  std::fclose(f);
+  CHECK(!ColbinReader::open(path).has_value());
+  std::remove(path);
+}
+
+TEST(colbin_widens_out_of_range_integers_to_float) {
+  const char* log = "colbin_u64.jsonl";
+  const char* sidecar = "colbin_u64.colbin";
+  std::FILE* f = std::fopen(log, "w");
+  CHECK(f != nullptr);
+  std::fprintf(f, "{\"id\":12}\n");
+  // A u64-style ID past INT64_MAX must widen the column, not wrap
+  // into a wrong negative int64.
+  std::fprintf(f, "{\"id\":18446744073709551615}\n");
+  std::fclose(f);
+
+  CHECK(compile(log, sidecar));
+  auto reader = ColbinReader::open(sidecar);
+  CHECK(reader.has_value());
+  auto id = reader->column("id");
+  CHECK(id.has_value());
+  CHECK(id->type() == ColumnType::kFloat64);
+  CHECK_EQ(id->float64s()[0], 12.0);
+  CHECK_EQ(id->float64s()[1], 18446744073709551615.0);
+  std::remove(log);
+  std::remove(sidecar);
+}
+
+TEST(colbin_handles_escaped_keys_and_unterminated_tail) {
+  const char* log = "colbin_escape.jsonl";
+  const char* sidecar = "colbin_escape.colbin";
+  std::FILE* f = std::fopen(log, "w");
+  CHECK(f != nullptr);
+  // A key containing an escaped quote must not mis-split the walk.
+  std::fprintf(f, "{\"a\\\"b\":1,\"plain\":10}\n");
+  std::fprintf(f, "{\"a\\\"b\":2,\"plain\":20}\n");
+  // Final record ends mid-file on a numeric value with no newline —
+  // its value view runs to the very last mapped byte.
+  std::fprintf(f, "{\"a\\\"b\":3,\"plain\":30}");
+  std::fclose(f);
+
+  CHECK(compile(log, sidecar));
+  auto reader = ColbinReader::open(sidecar);
+  CHECK(reader.has_value());
+  CHECK_EQ(reader->record_count(), 3u);
+  CHECK_EQ(reader->column_count(), 2u);
+
+  auto escaped = reader->column("a\\\"b");
+  CHECK(escaped.has_value());
+  CHECK(escaped->type() == ColumnType::kInt64);
+  CHECK_EQ(escaped->int64s()[0], 1);
+  CHECK_EQ(escaped->int64s()[2], 3);
+
+  auto plain = reader->column("plain");
+  CHECK(plain.has_value());
+  CHECK(plain->type() == ColumnType::kInt64);
+  CHECK_EQ(plain->int64s()[2], 30);
+  std::remove(log);
+  std::remove(sidecar);
+}
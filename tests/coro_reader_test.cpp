@@ -0,0 +1,122 @@
+#include "pipeline/coro_reader.h"
+
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include "framework.h"
+#include "jsonl/parser.h"
+
+using namespace proga;
+
+namespace {
+
+struct Counters {
+  uint64_t records = 0;
+  int64_t last_seq = -1;
+  bool ordered = true;
+};
+
+pipeline::CoroTask consume(pipeline::JsonlStream& stream, Counters& counters) {
+  for (;;) {
+    auto batch = co_await stream.next_batch();
+    for (const std::string& line : batch.records) {
+      jsonl::RecordView rec(line);
+      int64_t seq = rec.int_field("seq").value_or(-1);
+      if (seq != counters.last_seq + 1) counters.ordered = false;
+      counters.last_seq = seq;
+      ++counters.records;
+    }
+    if (batch.end_of_stream) co_return;
+  }
+}
+
+void write_records(std::FILE* f, int from, int count) {
+  for (int i = from; i < from + count; ++i) {
+    std::fprintf(f, "{\"seq\":%d}\n", i);
+  }
+  std::fflush(f);
+}
+
+}  // namespace
+
+TEST(coro_stream_drains_existing_file) {
+  const char* path = "coro_test.jsonl";
+  std::FILE* f = std::fopen(path, "w");
+  write_records(f, 0, 5000);
+  std::fclose(f);
+
+  pipeline::CoroExecutor executor(1);
+  pipeline::JsonlStream::Options options;
+  options.follow = false;
+  auto stream = pipeline::JsonlStream::open(executor, path, options);
+  CHECK(stream.has_value());
+  Counters counters;
+  executor.spawn(consume(*stream, counters));
+  executor.wait_idle();
+  CHECK_EQ(counters.records, 5000u);
+  CHECK(counters.ordered);
+  CHECK_EQ(stream->records_delivered(), 5000u);
+  std::remove(path);
+}
+
+TEST(coro_stream_follows_appends_until_stopped) {
+  const char* path = "coro_follow.jsonl";
+  std::FILE* f = std::fopen(path, "w");
+  write_records(f, 0, 100);
+
+  pipeline::CoroExecutor executor(1);
+  pipeline::JsonlStream::Options options;
+  options.poll_interval_ms = 2;
+  auto stream = pipeline::JsonlStream::open(executor, path, options);
+  CHECK(stream.has_value());
+  Counters counters;
+  executor.spawn(consume(*stream, counters));
+
+  // Appends land while the consumer is live.
+  for (int round = 0; round < 5; ++round) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    write_records(f, 100 + round * 100, 100);
+  }
+  std::fclose(f);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  stream->stop();
+  executor.wait_idle();
+  CHECK_EQ(counters.records, 600u);
+  CHECK(counters.ordered);
+  std::remove(path);
+}
+
+TEST(coro_many_streams_multiplex_on_one_worker) {
+  constexpr int kStreams = 20;
+  char path[64];
+  for (int s = 0; s < kStreams; ++s) {
+    std::snprintf(path, sizeof(path), "coro_multi_%d.jsonl", s);
+    std::FILE* f = std::fopen(path, "w");
+    write_records(f, 0, 300);
+    std::fclose(f);
+  }
+
+  pipeline::CoroExecutor executor(1);  // far fewer threads than streams
+  std::vector<pipeline::JsonlStream> streams;
+  std::vector<Counters> counters(kStreams);
+  pipeline::JsonlStream::Options options;
+  options.follow = false;
+  options.max_batch_records = 32;
+  for (int s = 0; s < kStreams; ++s) {
+    std::snprintf(path, sizeof(path), "coro_multi_%d.jsonl", s);
+    auto stream = pipeline::JsonlStream::open(executor, path, options);
+    CHECK(stream.has_value());
+    streams.push_back(std::move(*stream));
+  }
+  for (int s = 0; s < kStreams; ++s) {
+    executor.spawn(consume(streams[s], counters[s]));
+  }
+  executor.wait_idle();
+  for (int s = 0; s < kStreams; ++s) {
+    CHECK_EQ(counters[s].records, 300u);
+    CHECK(counters[s].ordered);
+    std::snprintf(path, sizeof(path), "coro_multi_%d.jsonl", s);
+    std::remove(path);
+  }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+// Minimal test registry shared by all test translation units. Define
+// tests with TEST(name) { ... } and assert with CHECK(expr) /
+// CHECK_EQ(a, b); the runner in runner_main.cpp executes everything
+// that registered itself.
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace proga::testing {
+
+struct TestCase {
+  std::string name;
+  std::function<void()> fn;
+};
+
+std::vector<TestCase>& registry();
+
+struct Registrar {
+  Registrar(const char* name, std::function<void()> fn) {
+    registry().push_back({name, std::move(fn)});
+  }
+};
+
+// Failure count for the currently running test; reset by the runner.
+extern int current_failures;
+
+}  // namespace proga::testing
+
+#define TEST(name)                                                    \
+  static void proga_test_##name();                                    \
+  static ::proga::testing::Registrar proga_test_registrar_##name(     \
+      #name, proga_test_##name);                                      \
+  static void proga_test_##name()
+
+#define CHECK(expr)                                                   \
+  do {                                                                \
+    if (!(expr)) {                                                    \
+      std::fprintf(stderr, "  CHECK failed at %s:%d: %s\n", __FILE__, \
+                   __LINE__, #expr);                                  \
+      ++::proga::testing::current_failures;                           \
+    }                                                                 \
+  } while (0)
+
+#define CHECK_EQ(a, b) CHECK((a) == (b))
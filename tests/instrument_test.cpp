@@ -0,0 +1,62 @@
+#include "util/instrument.h"
+
+#include <cstdio>
+
+#include "framework.h"
+#include "jsonl/parser.h"
+
+using namespace proga;
+
+TEST(instrument_stage_accumulates_samples) {
+  util::Instrumentation::reset();
+  util::Stage& stage = util::Instrumentation::stage("test.loop");
+  for (int i = 0; i < 1000; ++i) {
+    util::ScopedTimer timer(stage);
+  }
+  CHECK_EQ(stage.count.load(), 1000u);
+  CHECK(stage.cycles.load() > 0);
+  // Same name returns the same accumulator.
+  CHECK(&util::Instrumentation::stage("test.loop") == &stage);
+}
+
+TEST(instrument_snapshot_and_summary_formats) {
+  util::Instrumentation::reset();
+  util::Stage& stage = util::Instrumentation::stage("test.fmt");
+  { util::ScopedTimer timer(stage); }
+
+  std::string json = util::Instrumentation::snapshot_json();
+  CHECK(json.find("\"name\":\"test.fmt\"") != std::string::npos);
+  CHECK(json.find("\"count\":1") != std::string::npos);
+  CHECK(json.find("\"p99_ns\":") != std::string::npos);
+
+  std::string summary = util::Instrumentation::summary();
+  CHECK(summary.find("bench name=stage.test.fmt ") != std::string::npos);
+  CHECK(summary.find("ns_op=") != std::string::npos);
+  CHECK(summary.find("reps=1") != std::string::npos);
+
+  util::Instrumentation::reset();
+  CHECK_EQ(stage.count.load(), 0u);
+  // Idle stages are dropped from the summary.
+  CHECK(util::Instrumentation::summary().find("test.fmt") ==
+        std::string::npos);
+}
+
+#if defined(PROGA_INSTRUMENT)
+TEST(instrument_covers_file_reader_stage) {
+  util::Instrumentation::reset();
+  const char* path = "instrument_test.jsonl";
+  std::FILE* f = std::fopen(path, "w");
+  for (int i = 0; i < 500; ++i) std::fprintf(f, "{\"n\":%d}\n", i);
+  std::fclose(f);
+
+  auto reader = jsonl::JsonlFileReader::open(path);
+  CHECK(reader.has_value());
+  jsonl::RecordView rec;
+  while (reader->next(rec)) {
+  }
+
+  util::Stage& stage = util::Instrumentation::stage("parser.file_next");
+  CHECK_EQ(stage.count.load(), 501u);  // 500 records + the EOF call
+  std::remove(path);
+}
+#endif
@@ -0,0 +1,58 @@
+#include "mem/intern.h"
+
+#include <cstdio>
+#include <string>
+
+#include "framework.h"
+#include "jsonl/mmap_reader.h"
+
+using namespace proga;
+
+TEST(intern_assigns_dense_stable_symbols) {
+  mem::InternTable table;
+  auto get_ = table.intern("GET");
+  auto post = table.intern("POST");
+  CHECK_EQ(get_, 0u);
+  CHECK_EQ(post, 1u);
+  CHECK_EQ(table.intern("GET"), get_);
+  CHECK_EQ(table.size(), 2u);
+  CHECK_EQ(table.resolve(post), "POST");
+  CHECK_EQ(table.find("GET").value_or(99), get_);
+  CHECK(!table.find("DELETE").has_value());
+}
+
+TEST(intern_survives_growth) {
+  mem::InternTable table(/*expected_symbols=*/4);
+  std::vector<mem::InternTable::Symbol> symbols;
+  char buf[32];
+  for (int i = 0; i < 5000; ++i) {
+    std::snprintf(buf, sizeof(buf), "/api/v1/resource/%d", i);
+    symbols.push_back(table.intern(buf));
+  }
+  CHECK_EQ(table.size(), 5000u);
+  for (int i = 0; i < 5000; ++i) {
+    std::snprintf(buf, sizeof(buf), "/api/v1/resource/%d", i);
+    CHECK_EQ(table.intern(buf), symbols[i]);  // no duplicates on re-intern
+    CHECK_EQ(table.resolve(symbols[i]), buf);
+  }
+}
+
+TEST(intern_deduplicates_log_field_values) {
+  const char* path = "intern_log.jsonl";
+  std::FILE* f = std::fopen(path, "w");
+  for (int i = 0; i < 3000; ++i) {
+    std::fprintf(f, "{\"url\":\"/endpoint/%d\"}\n", i % 7);
+  }
+  std::fclose(f);
+
+  auto reader = jsonl::JsonlMmapReader::open(path);
+  mem::InternTable table;
+  jsonl::RecordView rec;
+  while (reader->next(rec)) {
+    table.intern(*rec.string_field("url"));
+  }
+  // 3000 records collapse to 7 distinct values.
+  CHECK_EQ(table.size(), 7u);
+  CHECK(table.string_bytes() < 200);
+  std::remove(path);
+}
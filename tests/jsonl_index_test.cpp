@@ -0,0 +1,109 @@
+#include "jsonl/index.h"
+
+#include <cstdio>
+#include <string>
+
+#include "framework.h"
+#include "jsonl/mmap_reader.h"
+
+using namespace proga;
+
+namespace {
+
+void append_records(const char* path, int first, int count) {
+  std::FILE* f = std::fopen(path, "a");
+  for (int i = first; i < first + count; ++i) {
+    std::fprintf(f, "{\"seq\":%d,\"pad\":\"%*d\"}\n", i, i % 37, i);
+  }
+  std::fclose(f);
+}
+
+}  // namespace
+
+TEST(index_seeks_to_any_record) {
+  const char* log = "index_test.jsonl";
+  const char* idx = "index_test.jsonl.idx";
+  std::remove(log);
+  append_records(log, 0, 300);
+  CHECK(jsonl::JsonlIndex::build(log, idx));
+
+  auto index = jsonl::JsonlIndex::open(idx);
+  CHECK(index.has_value());
+  CHECK_EQ(index->record_count(), 300u);
+
+  auto file = io::MmapFile::open(log, io::MmapFile::Advice::kRandom);
+  CHECK(file.has_value());
+  for (uint64_t n : {0u, 1u, 63u, 64u, 65u, 199u, 299u}) {
+    auto off = index->seek(n);
+    CHECK(off.has_value());
+    jsonl::RecordView rec(
+        file->view().substr(*off, file->view().find('\n', *off) - *off));
+    CHECK_EQ(rec.int_field("seq").value_or(-1), static_cast<int64_t>(n));
+  }
+  CHECK(!index->seek(300).has_value());
+  std::remove(log);
+  std::remove(idx);
+}
+
+TEST(index_update_is_incremental_over_appends) {
+  const char* log = "index_incr.jsonl";
+  const char* idx = "index_incr.jsonl.idx";
+  std::remove(log);
+  append_records(log, 0, 100);
+  CHECK(jsonl::JsonlIndex::build(log, idx));
+  append_records(log, 100, 50);
+  CHECK(jsonl::JsonlIndex::update(log, idx));
+
+  auto index = jsonl::JsonlIndex::open(idx);
+  CHECK(index.has_value());
+  CHECK_EQ(index->record_count(), 150u);
+
+  auto file = io::MmapFile::open(log, io::MmapFile::Advice::kRandom);
+  auto off = index->seek(149);
+  CHECK(off.has_value());
+  jsonl::RecordView rec(
+      file->view().substr(*off, file->view().find('\n', *off) - *off));
+  CHECK_EQ(rec.int_field("seq").value_or(-1), 149);
+
+  // update() on a missing index degrades to a full build.
+  std::remove(idx);
+  CHECK(jsonl::JsonlIndex::update(log, idx));
+  CHECK_EQ(jsonl::JsonlIndex::open(idx)->record_count(), 150u);
+  std::remove(log);
+  std::remove(idx);
+}
+
+TEST(index_update_handles_partial_final_line) {
+  const char* log = "index_partial.jsonl";
+  const char* idx = "index_partial.jsonl.idx";
+  std::remove(log);
+  append_records(log, 0, 100);
+  // The writer is mid-record when the first build runs.
+  std::FILE* f = std::fopen(log, "a");
+  std::fprintf(f, "{\"seq\":100,\"a\":1");
+  std::fclose(f);
+  CHECK(jsonl::JsonlIndex::build(log, idx));
+  CHECK_EQ(jsonl::JsonlIndex::open(idx)->record_count(), 100u);
+
+  // The line completes, more records land, and update() resumes.
+  f = std::fopen(log, "a");
+  std::fprintf(f, ",\"b\":2}\n");
+  std::fclose(f);
+  append_records(log, 101, 50);
+  CHECK(jsonl::JsonlIndex::update(log, idx));
+
+  auto index = jsonl::JsonlIndex::open(idx);
+  CHECK(index.has_value());
+  CHECK_EQ(index->record_count(), 151u);
+
+  auto file = io::MmapFile::open(log, io::MmapFile::Advice::kRandom);
+  for (uint64_t n : {99u, 100u, 101u, 150u}) {
+    auto off = index->seek(n);
+    CHECK(off.has_value());
+    jsonl::RecordView rec(
+        file->view().substr(*off, file->view().find('\n', *off) - *off));
+    CHECK_EQ(rec.int_field("seq").value_or(-1), static_cast<int64_t>(n));
+  }
+  std::remove(log);
+  std::remove(idx);
+}
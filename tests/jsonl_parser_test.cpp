@@ -0,0 +1,79 @@
+#include "jsonl/parser.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "framework.h"
+
+using namespace proga::jsonl;
+
+TEST(reader_yields_one_record_per_line) {
+  std::string buf =
+      "{\"method\":\"GET\",\"latency_ms\":12}\n"
+      "\n"
+      "{\"method\":\"POST\",\"latency_ms\":450}\r\n";
+  JsonlReader reader(buf);
+  RecordView rec;
+  CHECK(reader.next(rec));
+  CHECK_EQ(rec.string_field("method").value_or(""), "GET");
+  CHECK(reader.next(rec));
+  CHECK_EQ(rec.string_field("method").value_or(""), "POST");
+  CHECK_EQ(rec.int_field("latency_ms").value_or(-1), 450);
+  CHECK(!reader.next(rec));
+  CHECK_EQ(reader.records_read(), 2u);
+}
+
+TEST(field_lookup_handles_nesting_and_escapes) {
+  RecordView rec(
+      "{\"url\":\"/a\\\"b\",\"tags\":[1,{\"x\":2}],\"n\":-3,"
+      "\"f\":1.5,\"ok\":true}");
+  CHECK_EQ(rec.string_field("url").value_or(""), "/a\\\"b");
+  CHECK_EQ(rec.field("tags").value_or(""), "[1,{\"x\":2}]");
+  CHECK_EQ(rec.int_field("n").value_or(0), -3);
+  CHECK_EQ(rec.double_field("f").value_or(0.0), 1.5);
+  CHECK_EQ(rec.field("ok").value_or(""), "true");
+  CHECK(!rec.field("missing").has_value());
+  // Keys of nested objects must not shadow top-level lookup.
+  CHECK(!rec.field("x").has_value());
+}
+
+TEST(int_field_rejects_overflow_at_the_range_edges) {
+  RecordView rec(
+      "{\"max\":9223372036854775807,\"min\":-9223372036854775808,"
+      "\"u64\":18446744073709551615,\"over\":9223372036854775808,"
+      "\"under\":-9223372036854775809,\"huge\":12345678901234567890123}");
+  CHECK_EQ(rec.int_field("max").value_or(0), INT64_MAX);
+  CHECK_EQ(rec.int_field("min").value_or(0), INT64_MIN);
+  // Out-of-range integers must not wrap; callers fall back to the
+  // float path, which still sees the magnitude.
+  CHECK(!rec.int_field("u64").has_value());
+  CHECK(!rec.int_field("over").has_value());
+  CHECK(!rec.int_field("under").has_value());
+  CHECK(!rec.int_field("huge").has_value());
+  CHECK_EQ(rec.double_field("u64").value_or(0), 18446744073709551615.0);
+}
+
+TEST(file_reader_streams_across_refills) {
+  const char* path = "parser_test.jsonl";
+  std::FILE* f = std::fopen(path, "w");
+  CHECK(f != nullptr);
+  for (int i = 0; i < 1000; ++i) {
+    std::fprintf(f, "{\"seq\":%d,\"pad\":\"%s\"}\n", i,
+                 std::string(64, 'x').c_str());
+  }
+  // No trailing newline on the final record.
+  std::fprintf(f, "{\"seq\":1000}");
+  std::fclose(f);
+
+  auto reader = JsonlFileReader::open(path, /*buffer_size=*/256);
+  CHECK(reader.has_value());
+  RecordView rec;
+  int64_t expected = 0;
+  while (reader->next(rec)) {
+    CHECK_EQ(rec.int_field("seq").value_or(-1), expected);
+    ++expected;
+  }
+  CHECK_EQ(expected, 1001);
+  std::remove(path);
+}
@@ -0,0 +1,72 @@
+#include "jsonl/mmap_reader.h"
+
+#include <cstdio>
+#include <string>
+
+#include "framework.h"
+
+using namespace proga;
+
+TEST(mmap_reader_serves_views_into_mapping) {
+  const char* path = "mmap_test.jsonl";
+  std::FILE* f = std::fopen(path, "w");
+  CHECK(f != nullptr);
+  std::fprintf(f, "{\"a\":1}\n{\"a\":2}\n");
+  std::fclose(f);
+
+  auto reader = jsonl::JsonlMmapReader::open(path);
+  CHECK(reader.has_value());
+  const char* base = reader->file().data();
+  jsonl::RecordView rec;
+  CHECK(reader->next(rec));
+  // Zero-copy: the view must alias the mapping, not a heap copy.
+  CHECK(rec.raw().data() >= base &&
+        rec.raw().data() < base + reader->file().size());
+  CHECK_EQ(rec.int_field("a").value_or(0), 1);
+  CHECK(reader->next(rec));
+  CHECK_EQ(rec.int_field("a").value_or(0), 2);
+  CHECK(!reader->next(rec));
+  std::remove(path);
+}
+
+TEST(mmap_open_handles_missing_and_empty_files) {
+  CHECK(!io::MmapFile::open("does_not_exist.jsonl").has_value());
+
+  const char* path = "mmap_empty.jsonl";
+  std::FILE* f = std::fopen(path, "w");
+  std::fclose(f);
+  auto file = io::MmapFile::open(path, io::MmapFile::Advice::kRandom);
+  CHECK(file.has_value());
+  CHECK_EQ(file->size(), 0u);
+  std::remove(path);
+}
+
+TEST(mmap_reader_prefaults_ahead_of_cursor) {
+  const char* path = "mmap_prefault.jsonl";
+  std::FILE* f = std::fopen(path, "w");
+  CHECK(f != nullptr);
+  for (int i = 0; i < 20000; ++i) {
+    CHECK(std::fprintf(f, "{\"seq\":%d,\"pad\":\"%0100d\"}\n", i, 0) > 0);
+  }
+  CHECK_EQ(std::fclose(f), 0);
+
+  jsonl::JsonlMmapReader::Options options;
+  options.huge_pages = true;
+  options.prefault_window_bytes = 1 << 20;
+  auto reader = jsonl::JsonlMmapReader::open(path, options);
+  CHECK(reader.has_value());
+  reader->start_prefault();
+
+  jsonl::RecordView rec;
+  int64_t expected = 0;
+  while (reader->next(rec)) {
+    CHECK_EQ(rec.int_field("seq").value_or(-1), expected);
+    ++expected;
+  }
+  CHECK_EQ(expected, 20000);
+  // With the cursor at EOF the toucher's window covers the remainder
+  // of the mapping; wait for it to finish walking it.
+  reader->wait_prefault();
+  CHECK_EQ(reader->bytes_prefaulted(), reader->file().size());
+  std::remove(path);
+}
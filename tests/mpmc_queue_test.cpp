@@ -0,0 +1,71 @@
+#include "concurrency/mpmc_queue.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "framework.h"
+
+using namespace proga::concurrency;
+
+TEST(mpmc_single_thread_fifo_and_bounds) {
+  MpmcQueue<int> q(4);
+  CHECK_EQ(q.capacity(), 4u);
+  for (int i = 0; i < 4; ++i) CHECK(q.try_push(int(i)));
+  int overflow = 99;
+  CHECK(!q.try_push(std::move(overflow)));
+  int v = -1;
+  for (int i = 0; i < 4; ++i) {
+    CHECK(q.try_pop(v));
+    CHECK_EQ(v, i);
+  }
+  CHECK(!q.try_pop(v));
+}
+
+TEST(mpmc_batch_ops) {
+  MpmcQueue<int> q(8);
+  std::vector<int> in = {1, 2, 3, 4, 5};
+  CHECK_EQ(q.try_push_batch(std::span<int>(in)), 5u);
+  int out[8];
+  CHECK_EQ(q.try_pop_batch(out, 8), 5u);
+  CHECK_EQ(out[0], 1);
+  CHECK_EQ(out[4], 5);
+}
+
+TEST(mpmc_concurrent_producers_and_consumers) {
+  constexpr int kProducers = 3;
+  constexpr int kConsumers = 3;
+  constexpr int kPerProducer = 20000;
+  MpmcQueue<int> q(1024);
+  std::atomic<long long> sum{0};
+  std::atomic<int> popped{0};
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < kProducers; ++p) {
+    threads.emplace_back([&q, p] {
+      for (int i = 0; i < kPerProducer; ++i) {
+        int value = p * kPerProducer + i;
+        while (!q.try_push(std::move(value))) std::this_thread::yield();
+      }
+    });
+  }
+  for (int c = 0; c < kConsumers; ++c) {
+    threads.emplace_back([&] {
+      int v;
+      while (popped.load(std::memory_order_relaxed) <
+             kProducers * kPerProducer) {
+        if (q.try_pop(v)) {
+          sum.fetch_add(v, std::memory_order_relaxed);
+          popped.fetch_add(1, std::memory_order_relaxed);
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+
+  long long n = kProducers * kPerProducer;
+  CHECK_EQ(popped.load(), n);
+  CHECK_EQ(sum.load(), n * (n - 1) / 2);
+}
@@ -0,0 +1,42 @@
+#include "sched/numa.h"
+
+#include <thread>
+#include <vector>
+
+#include "framework.h"
+
+using namespace proga;
+
+TEST(numa_topology_has_at_least_one_node) {
+  const auto& topology = sched::NumaTopology::get();
+  CHECK(topology.node_count() >= 1);
+  size_t total_cpus = 0;
+  for (const auto& node : topology.nodes()) {
+    CHECK(!node.cpus.empty());
+    total_cpus += node.cpus.size();
+  }
+  CHECK(total_cpus >= 1);
+  // Worker mapping wraps round-robin.
+  const auto& first = topology.node_for_worker(0);
+  const auto& wrapped = topology.node_for_worker(topology.node_count());
+  CHECK_EQ(first.id, wrapped.id);
+}
+
+TEST(numa_pin_current_thread_to_own_node) {
+  const auto& topology = sched::NumaTopology::get();
+  std::thread t([&] {
+    // Pinning to a real node must succeed outside restrictive cpusets;
+    // tolerate failure but never crash.
+    sched::NumaTopology::pin_current_thread(topology.nodes()[0]);
+  });
+  t.join();
+}
+
+TEST(numa_first_touch_faults_every_page) {
+  std::vector<char> buffer(1 << 18, 0);
+  sched::NumaTopology::first_touch(buffer.data(), buffer.size());
+  // The contents survive the touch (read-modify-write, not a clear).
+  buffer[4096] = 7;
+  sched::NumaTopology::first_touch(buffer.data(), buffer.size());
+  CHECK_EQ(buffer[4096], 7);
+}
@@ -0,0 +1,63 @@
+#include "query/predicate.h"
+
+#include <cstdio>
+
+#include "framework.h"
+#include "jsonl/mmap_reader.h"
+
+using namespace proga;
+
+TEST(predicate_comparisons_and_logic) {
+  jsonl::RecordView rec(
+      "{\"method\":\"POST\",\"url\":\"/api/v1/users\",\"latency_ms\":750,"
+      "\"status\":200}");
+
+  auto p = query::Predicate::parse("method == \"POST\" && latency_ms > 500");
+  CHECK(p.has_value());
+  CHECK(p->matches(rec));
+
+  CHECK(!query::Predicate::parse("latency_ms > 800")->matches(rec));
+  CHECK(query::Predicate::parse("latency_ms <= 750")->matches(rec));
+  CHECK(query::Predicate::parse("url contains 'users'")->matches(rec));
+  CHECK(query::Predicate::parse("status != 500")->matches(rec));
+  CHECK(query::Predicate::parse("!(method == 'GET') || status == 999")
+            ->matches(rec));
+  // Missing fields never match.
+  CHECK(!query::Predicate::parse("absent == 1")->matches(rec));
+
+  CHECK(!query::Predicate::parse("method ==").has_value());
+  CHECK(!query::Predicate::parse("&& latency_ms > 1").has_value());
+  CHECK(!query::Predicate::parse("method == 'GET' garbage").has_value());
+}
+
+TEST(predicate_prefilter_rejects_without_field_parse) {
+  auto p = query::Predicate::parse("method == \"DELETE\" && latency_ms > 1");
+  CHECK(p.has_value());
+  CHECK_EQ(p->required_substrings().size(), 1u);
+  CHECK_EQ(p->required_substrings()[0], "DELETE");
+  CHECK(!p->may_match("{\"method\":\"GET\",\"latency_ms\":9}"));
+  CHECK(p->may_match("{\"method\":\"DELETE\",\"latency_ms\":9}"));
+
+  // OR offers no guarantee, so no prefilter substrings.
+  auto q = query::Predicate::parse("method == 'PUT' || status == 1");
+  CHECK(q->required_substrings().empty());
+}
+
+TEST(predicate_scan_over_log) {
+  const char* path = "predicate_scan.jsonl";
+  std::FILE* f = std::fopen(path, "w");
+  for (int i = 0; i < 1000; ++i) {
+    std::fprintf(f, "{\"method\":\"%s\",\"latency_ms\":%d}\n",
+                 i % 100 == 0 ? "POST" : "GET", i);
+  }
+  std::fclose(f);
+
+  auto reader = jsonl::JsonlMmapReader::open(path);
+  auto pred = query::Predicate::parse("method == 'POST' && latency_ms >= 500");
+  CHECK(pred.has_value());
+  size_t matches = query::scan(*reader, *pred, [](const jsonl::RecordView& r) {
+    CHECK_EQ(r.string_field("method").value_or(""), "POST");
+  });
+  CHECK_EQ(matches, 5u);  // 500, 600, 700, 800, 900
+  std::remove(path);
+}
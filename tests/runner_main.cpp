@@ -0,0 +1,126 @@
+// Test runner. Executes every registered TEST, records per-test wall
+// time and peak RSS, and writes a machine-readable report to
+// test_output.txt. Each test is checked against a time/memory budget
+// from tests/budgets.txt; exceeding a budget fails the run even when
+// all checks pass, which is how O(n^2) regressions get caught before
+// they ship.
+
+#include <sys/resource.h>
+
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <string>
+
+#include "framework.h"
+
+namespace proga::testing {
+
+std::vector<TestCase>& registry() {
+  static std::vector<TestCase> cases;
+  return cases;
+}
+
+int current_failures = 0;
+
+namespace {
+
+struct Budget {
+  double max_ms = 5000;
+  long max_rss_kb = 262144;
+};
+
+// budgets.txt: one entry per line, "<test-name|default> <max_ms>
+// <max_rss_kb>"; '#' starts a comment.
+std::map<std::string, Budget> load_budgets(const char* path) {
+  std::map<std::string, Budget> budgets;
+  std::FILE* f = path != nullptr ? std::fopen(path, "r") : nullptr;
+  if (f == nullptr) return budgets;
+  char name[256];
+  double max_ms;
+  long max_rss_kb;
+  char line[512];
+  while (std::fgets(line, sizeof(line), f) != nullptr) {
+    if (line[0] == '#' || line[0] == '\n') continue;
+    if (std::sscanf(line, "%255s %lf %ld", name, &max_ms, &max_rss_kb) == 3) {
+      budgets[name] = Budget{max_ms, max_rss_kb};
+    }
+  }
+  std::fclose(f);
+  return budgets;
+}
+
+long peak_rss_kb() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+}  // namespace
+}  // namespace proga::testing
+
+int main(int argc, char** argv) {
+  using namespace proga::testing;
+  using Clock = std::chrono::steady_clock;
+
+  const char* budgets_path = nullptr;
+  const char* output_path = "test_output.txt";
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--budgets") == 0 && i + 1 < argc) {
+      budgets_path = argv[++i];
+    } else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+      output_path = argv[++i];
+    }
+  }
+  auto budgets = load_budgets(budgets_path);
+  Budget default_budget;
+  if (auto it = budgets.find("default"); it != budgets.end()) {
+    default_budget = it->second;
+  }
+
+  std::FILE* out = std::fopen(output_path, "w");
+  int failed_tests = 0;
+  for (const TestCase& tc : registry()) {
+    current_failures = 0;
+    std::printf("[ RUN  ] %s\n", tc.name.c_str());
+    auto start = Clock::now();
+    tc.fn();
+    auto stop = Clock::now();
+    double wall_ms =
+        std::chrono::duration<double, std::milli>(stop - start).count();
+    // ru_maxrss is a process-wide high-water mark, so this is the peak
+    // as of this test, not a per-test delta.
+    long rss_kb = peak_rss_kb();
+
+    Budget budget = default_budget;
+    if (auto it = budgets.find(tc.name); it != budgets.end()) {
+      budget = it->second;
+    }
+    const char* status = "ok";
+    if (current_failures > 0) {
+      status = "fail";
+    } else if (wall_ms > budget.max_ms || rss_kb > budget.max_rss_kb) {
+      status = "over_budget";
+    }
+    if (std::strcmp(status, "ok") != 0) ++failed_tests;
+    std::printf("[ %-4s ] %s (%.2f ms, rss %ld kB)\n",
+                current_failures == 0 && std::strcmp(status, "ok") == 0
+                    ? "OK"
+                    : "FAIL",
+                tc.name.c_str(), wall_ms, rss_kb);
+    if (out != nullptr) {
+      std::fprintf(out,
+                   "test name=%s status=%s wall_ms=%.3f rss_kb=%ld "
+                   "budget_ms=%.0f budget_rss_kb=%ld checks_failed=%d\n",
+                   tc.name.c_str(), status, wall_ms, rss_kb, budget.max_ms,
+                   budget.max_rss_kb, current_failures);
+    }
+  }
+  std::printf("%zu tests, %d failed\n", registry().size(), failed_tests);
+  if (out != nullptr) {
+    std::fprintf(out, "summary tests=%zu failed=%d\n", registry().size(),
+                 failed_tests);
+    std::fclose(out);
+  }
+  return failed_tests == 0 ? 0 : 1;
+}
@@ -0,0 +1,69 @@
+#include "jsonl/schema.h"
+
+#include "framework.h"
+
+using namespace proga;
+
+using RequestSchema =
+    jsonl::Schema<jsonl::Field<"url", std::string_view>,
+                  jsonl::Field<"latency_ms", double>,
+                  jsonl::Field<"status", int64_t>>;
+
+TEST(schema_parse_and_typed_get) {
+  jsonl::RecordView rec(
+      "{\"url\":\"/api/v1\",\"latency_ms\":12.5,\"status\":200}");
+  RequestSchema::Row row;
+  CHECK(RequestSchema::parse(rec, row));
+  CHECK_EQ(RequestSchema::get<"url">(row).value_or(""), "/api/v1");
+  CHECK_EQ(RequestSchema::get<"latency_ms">(row).value_or(0), 12.5);
+  CHECK_EQ(RequestSchema::get<"status">(row).value_or(-1), 200);
+}
+
+TEST(schema_handles_reordered_and_extra_keys) {
+  jsonl::RecordView rec(
+      "{\"status\":404,\"extra\":[1,2],\"url\":\"/x\",\"latency_ms\":3}");
+  RequestSchema::Row row;
+  CHECK(RequestSchema::parse(rec, row));
+  CHECK_EQ(RequestSchema::get<"status">(row).value_or(-1), 404);
+  CHECK_EQ(RequestSchema::get<"url">(row).value_or(""), "/x");
+}
+
+TEST(schema_missing_field_falls_back_to_dynamic) {
+  jsonl::RecordView rec("{\"url\":\"/y\",\"status\":500}");
+  RequestSchema::Row row;
+  CHECK(!RequestSchema::parse(rec, row));
+  // Unknown shape: the dynamic path still serves what is there.
+  CHECK_EQ(rec.int_field("status").value_or(-1), 500);
+}
+
+TEST(schema_get_reports_unconvertible_value) {
+  jsonl::RecordView rec(
+      "{\"url\":\"/z\",\"latency_ms\":\"n/a\",\"status\":200}");
+  RequestSchema::Row row;
+  CHECK(RequestSchema::parse(rec, row));
+  CHECK(!RequestSchema::get<"latency_ms">(row).has_value());
+  CHECK_EQ(RequestSchema::get<"status">(row).value_or(-1), 200);
+}
+
+TEST(schema_registry_declares_and_validates) {
+  jsonl::SchemaRegistry registry;
+  registry.declare("request", {{"request_id", jsonl::FieldType::kString},
+                               {"latency_ms", jsonl::FieldType::kDouble}});
+  const auto* schema = registry.find("request");
+  CHECK(schema != nullptr);
+  CHECK(registry.find("unknown") == nullptr);
+
+  jsonl::RecordView good(
+      "{\"request_id\":\"user-001\",\"latency_ms\":7,\"extra\":1}");
+  jsonl::RecordView bad_type(
+      "{\"request_id\":\"user-001\",\"latency_ms\":\"slow\"}");
+  jsonl::RecordView missing("{\"request_id\":\"user-001\"}");
+  CHECK(jsonl::SchemaRegistry::conforms(good, *schema));
+  CHECK(!jsonl::SchemaRegistry::conforms(bad_type, *schema));
+  CHECK(!jsonl::SchemaRegistry::conforms(missing, *schema));
+
+  // Redeclaring replaces in place.
+  registry.declare("request", {{"request_id", jsonl::FieldType::kString}});
+  CHECK_EQ(registry.size(), 1u);
+  CHECK(jsonl::SchemaRegistry::conforms(missing, *registry.find("request")));
+}
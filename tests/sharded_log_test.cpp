@@ -0,0 +1,113 @@
+#include "io/sharded_log.h"
+
+#include <cstdio>
+#include <map>
+
+#include "framework.h"
+#include "jsonl/mmap_reader.h"
+
+using namespace proga;
+
+namespace {
+
+void remove_layout(const char* stem, unsigned shards) {
+  char path[64];
+  for (unsigned i = 0; i < shards; ++i) {
+    std::snprintf(path, sizeof(path), "%s.%04u.jsonl", stem, i);
+    std::remove(path);
+  }
+  std::snprintf(path, sizeof(path), "%s.manifest", stem);
+  std::remove(path);
+}
+
+}  // namespace
+
+TEST(sharded_round_robin_replay_restores_order) {
+  io::ShardedLogWriter::Options options;
+  options.shard_count = 3;
+  {
+    auto writer = io::ShardedLogWriter::open("shard_rr.jsonl", options);
+    CHECK(writer.has_value());
+    char record[64];
+    for (int i = 0; i < 3000; ++i) {
+      std::snprintf(record, sizeof(record), "{\"value\":%d}", i);
+      CHECK(writer->append(record));
+    }
+    CHECK(writer->flush());
+    CHECK_EQ(writer->records_written(), 3000u);
+  }
+
+  // Each shard holds a third of the records.
+  auto shard = jsonl::JsonlMmapReader::open("shard_rr.0000.jsonl");
+  CHECK(shard.has_value());
+  jsonl::RecordView rec;
+  size_t count = 0;
+  while (shard->next(rec)) ++count;
+  CHECK_EQ(count, 1000u);
+
+  // Replay merges by the embedded sequence number.
+  auto reader = io::ShardedLogReader::open("shard_rr.manifest");
+  CHECK(reader.has_value());
+  CHECK_EQ(reader->shard_count(), 3u);
+  int64_t expected = 0;
+  while (reader->next(rec)) {
+    CHECK_EQ(rec.int_field("seq").value_or(-1), expected);
+    CHECK_EQ(rec.int_field("value").value_or(-1), expected);
+    ++expected;
+  }
+  CHECK_EQ(expected, 3000);
+  remove_layout("shard_rr", 3);
+}
+
+TEST(sharded_hash_partition_keeps_keys_together) {
+  io::ShardedLogWriter::Options options;
+  options.shard_count = 4;
+  options.partition = io::ShardedLogWriter::Partition::kHashField;
+  options.hash_field = "user";
+  options.sequence_field.clear();  // unordered replay
+  {
+    auto writer = io::ShardedLogWriter::open("shard_hash.jsonl", options);
+    CHECK(writer.has_value());
+    char record[64];
+    for (int i = 0; i < 2000; ++i) {
+      std::snprintf(record, sizeof(record), "{\"user\":\"u%d\",\"n\":%d}",
+                    i % 16, i);
+      CHECK(writer->append(record));
+    }
+    CHECK(writer->flush());
+  }
+
+  // Every user's records live on exactly one shard.
+  char path[64];
+  std::map<std::string, unsigned> shard_of;
+  for (unsigned s = 0; s < 4; ++s) {
+    std::snprintf(path, sizeof(path), "shard_hash.%04u.jsonl", s);
+    auto shard = jsonl::JsonlMmapReader::open(path);
+    CHECK(shard.has_value());
+    jsonl::RecordView rec;
+    while (shard->next(rec)) {
+      std::string user(rec.string_field("user").value_or(""));
+      auto [it, inserted] = shard_of.emplace(user, s);
+      CHECK(it->second == s);
+    }
+  }
+  CHECK_EQ(shard_of.size(), 16u);
+
+  auto reader = io::ShardedLogReader::open("shard_hash.manifest");
+  CHECK(reader.has_value());
+  jsonl::RecordView rec;
+  size_t total = 0;
+  while (reader->next(rec)) ++total;
+  CHECK_EQ(total, 2000u);
+  remove_layout("shard_hash", 4);
+}
+
+TEST(sharded_reader_rejects_bad_manifest) {
+  const char* path = "bad.manifest";
+  std::FILE* f = std::fopen(path, "w");
+  std::fprintf(f, "notsharded 1\n");
+  std::fclose(f);
+  CHECK(!io::ShardedLogReader::open(path).has_value());
+  CHECK(!io::ShardedLogReader::open("missing.manifest").has_value());
+  std::remove(path);
+}
@@ -0,0 +1,95 @@
+#include "jsonl/skip_index.h"
+
+#include <cstdio>
+
+#include "framework.h"
+
+using namespace proga;
+
+namespace {
+
+void write_log(const char* path, int records) {
+  std::FILE* f = std::fopen(path, "w");
+  for (int i = 0; i < records; ++i) {
+    std::fprintf(f,
+                 "{\"request_id\":\"req-%06d\",\"url\":\"/e/%d\","
+                 "\"pad\":\"%0200d\"}\n",
+                 i, i % 7, 0);
+  }
+  std::fclose(f);
+}
+
+}  // namespace
+
+TEST(skip_index_point_lookup_prunes_blocks) {
+  const char* log = "skip_test.jsonl";
+  const char* idx = "skip_test.jsonl.bloom";
+  write_log(log, 20000);  // ~4.7 MB
+
+  jsonl::BloomSkipIndex::Options options;
+  options.key_fields = {"request_id"};
+  options.block_bytes = 256 << 10;
+  auto built = jsonl::BloomSkipIndex::build(log, idx, options);
+  CHECK(built.has_value());
+  CHECK(built->block_count() > 10);
+
+  auto index = jsonl::BloomSkipIndex::open(idx);
+  CHECK(index.has_value());
+  CHECK_EQ(index->block_count(), built->block_count());
+  CHECK_EQ(index->key_fields().size(), 1u);
+
+  // One id lives in exactly one block: the candidate set must be a
+  // small fraction of the log.
+  auto ranges = index->candidate_ranges("request_id", "req-012345");
+  CHECK(!ranges.empty());
+  uint64_t candidate_bytes = 0;
+  for (const auto& r : ranges) candidate_bytes += r.end - r.begin;
+  CHECK(candidate_bytes < (1u << 20));
+
+  size_t hits = 0;
+  CHECK(index->scan_candidates(log, "request_id", "req-012345",
+                               [&](const jsonl::RecordView& rec) {
+                                 if (rec.string_field("request_id") ==
+                                     "req-012345") {
+                                   ++hits;
+                                 }
+                               }));
+  CHECK_EQ(hits, 1u);
+
+  // An absent id is (almost always) pruned everywhere.
+  CHECK(!index->may_contain("request_id", "req-999999"));
+  std::remove(log);
+  std::remove(idx);
+}
+
+TEST(skip_index_unindexed_field_cannot_prune) {
+  const char* log = "skip_unidx.jsonl";
+  const char* idx = "skip_unidx.bloom";
+  write_log(log, 500);
+  jsonl::BloomSkipIndex::Options options;
+  options.key_fields = {"request_id"};
+  auto index = jsonl::BloomSkipIndex::build(log, idx, options);
+  CHECK(index.has_value());
+  // "url" was not indexed: every block stays a candidate.
+  auto ranges = index->candidate_ranges("url", "/e/3");
+  uint64_t covered = 0;
+  for (const auto& r : ranges) covered += r.end - r.begin;
+  size_t logged = 0;
+  std::FILE* f = std::fopen(log, "rb");
+  std::fseek(f, 0, SEEK_END);
+  logged = static_cast<size_t>(std::ftell(f));
+  std::fclose(f);
+  CHECK_EQ(covered, logged);
+  std::remove(log);
+  std::remove(idx);
+}
+
+TEST(skip_index_rejects_bad_input) {
+  jsonl::BloomSkipIndex::Options options;  // no key fields
+  CHECK(!jsonl::BloomSkipIndex::build("skip_missing.jsonl", "x.bloom", options)
+             .has_value());
+  options.key_fields = {"request_id"};
+  CHECK(!jsonl::BloomSkipIndex::build("skip_missing.jsonl", "x.bloom", options)
+             .has_value());
+  CHECK(!jsonl::BloomSkipIndex::open("skip_missing.bloom").has_value());
+}
@@ -0,0 +1,112 @@
+#include "jsonl/time_index.h"
+
+#include <cstdio>
+
+#include "framework.h"
+
+using namespace proga;
+
+namespace {
+
+// 20000 records, timestamps 1000.0 upward in steps of 0.5, padded so
+// the log spans many 64 KiB blocks.
+void write_ordered_log(const char* path, int records) {
+  std::FILE* f = std::fopen(path, "w");
+  for (int i = 0; i < records; ++i) {
+    std::fprintf(f, "{\"ts\":%.1f,\"url\":\"/e/%d\",\"pad\":\"%0100d\"}\n",
+                 1000.0 + i * 0.5, i % 7, 0);
+  }
+  std::fclose(f);
+}
+
+}  // namespace
+
+TEST(time_index_prunes_outside_requested_window) {
+  const char* log = "tidx_test.jsonl";
+  const char* idx = "tidx_test.jsonl.tidx";
+  write_ordered_log(log, 20000);
+
+  jsonl::TimeIndex::Options options;
+  options.block_bytes = 64 << 10;
+  auto built = jsonl::TimeIndex::build(log, idx, options);
+  CHECK(built.has_value());
+  CHECK(built->block_count() > 10);
+  CHECK(built->time_ordered());
+
+  auto index = jsonl::TimeIndex::open(idx);
+  CHECK(index.has_value());
+  CHECK_EQ(index->block_count(), built->block_count());
+  CHECK(index->time_ordered());
+
+  // A 500-tick window out of 10000: candidates must be a small slice.
+  auto ranges = index->candidate_ranges(4000.0, 4500.0);
+  CHECK(!ranges.empty());
+  uint64_t candidate_bytes = 0;
+  for (const auto& r : ranges) candidate_bytes += r.end - r.begin;
+  std::FILE* f = std::fopen(log, "rb");
+  std::fseek(f, 0, SEEK_END);
+  uint64_t log_bytes = static_cast<uint64_t>(std::ftell(f));
+  std::fclose(f);
+  CHECK(candidate_bytes < log_bytes / 10);
+
+  size_t hits = 0;
+  double last = 0;
+  CHECK(index->scan_range(log, 4000.0, 4500.0,
+                          [&](const jsonl::RecordView& rec) {
+                            double ts = rec.double_field("ts").value_or(-1);
+                            CHECK(ts >= 4000.0 && ts <= 4500.0);
+                            CHECK(ts > last);
+                            last = ts;
+                            ++hits;
+                          }));
+  CHECK_EQ(hits, 1001u);  // 4000.0 .. 4500.0 in 0.5 steps, inclusive
+
+  // A window before/after the log prunes everything.
+  CHECK(index->candidate_ranges(0.0, 999.0).empty());
+  CHECK(index->candidate_ranges(99999.0, 100000.0).empty());
+  std::remove(log);
+  std::remove(idx);
+}
+
+TEST(time_index_handles_unordered_log) {
+  const char* log = "tidx_unordered.jsonl";
+  const char* idx = "tidx_unordered.tidx";
+  std::FILE* f = std::fopen(log, "w");
+  for (int i = 0; i < 12000; ++i) {
+    // Two interleaved streams make block ranges overlap.
+    double ts = (i % 2 == 0) ? 1000.0 + i : 5000.0 + i;
+    std::fprintf(f, "{\"ts\":%.1f,\"pad\":\"%0100d\"}\n", ts, 0);
+  }
+  std::fclose(f);
+
+  jsonl::TimeIndex::Options options;
+  options.block_bytes = 64 << 10;
+  auto index = jsonl::TimeIndex::build(log, idx, options);
+  CHECK(index.has_value());
+  CHECK(!index->time_ordered());
+
+  size_t hits = 0;
+  CHECK(index->scan_range(log, 5000.0, 5100.0,
+                          [&](const jsonl::RecordView&) { ++hits; }));
+  // Odd i in [0, 100]: 50 records; even i with 1000 + i in range don't
+  // exist (they'd need i >= 4000, which lands at 5000+... checked via
+  // the window): count the matches directly instead.
+  size_t expected = 0;
+  for (int i = 0; i < 12000; ++i) {
+    double ts = (i % 2 == 0) ? 1000.0 + i : 5000.0 + i;
+    if (ts >= 5000.0 && ts <= 5100.0) ++expected;
+  }
+  CHECK_EQ(hits, expected);
+  std::remove(log);
+  std::remove(idx);
+}
+
+TEST(time_index_rejects_bad_input) {
+  jsonl::TimeIndex::Options options;
+  options.timestamp_field.clear();
+  CHECK(!jsonl::TimeIndex::build("tidx_missing.jsonl", "x.tidx", options)
+             .has_value());
+  CHECK(!jsonl::TimeIndex::build("tidx_missing.jsonl", "x.tidx", {})
+             .has_value());
+  CHECK(!jsonl::TimeIndex::open("tidx_missing.tidx").has_value());
+}
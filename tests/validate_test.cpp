@@ -0,0 +1,103 @@
+#include "jsonl/validate.h"
+
+#include <cstdio>
+#include <string>
+
+#include "framework.h"
+
+using namespace proga;
+
+TEST(utf8_validator_accepts_and_rejects) {
+  auto valid = [](const std::string& s) {
+    return jsonl::detail::validate_utf8(s.data(), s.size());
+  };
+  CHECK(valid(""));
+  CHECK(valid("plain ascii {\"key\":123}"));
+  CHECK(valid(std::string(1000, 'a') + "caf\xc3\xa9"));  // 2-byte é
+  CHECK(valid("\xe2\x82\xac"));                          // 3-byte €
+  CHECK(valid("\xf0\x9f\x9a\x80"));                      // 4-byte rocket
+  CHECK(!valid("\x80"));              // stray continuation
+  CHECK(!valid("\xc3"));              // truncated 2-byte
+  CHECK(!valid("\xc0\xaf"));          // overlong
+  CHECK(!valid("\xe0\x80\x80"));      // overlong 3-byte
+  CHECK(!valid("\xed\xa0\x80"));      // surrogate
+  CHECK(!valid("\xf4\x90\x80\x80"));  // past U+10FFFF
+  CHECK(!valid("\xff"));
+  // Bad byte beyond the vectorized ASCII prefix.
+  CHECK(!valid(std::string(4096, 'x') + "\xc3\x28"));
+}
+
+TEST(validator_checks_schema_and_timestamps) {
+  jsonl::SchemaRegistry registry;
+  registry.declare("request", {{"url", jsonl::FieldType::kString},
+                               {"ts", jsonl::FieldType::kDouble}});
+  jsonl::Validator::Options options;
+  options.schema = registry.find("request");
+  options.timestamp_field = "ts";
+  jsonl::Validator validator(options);
+
+  CHECK(validator.add(jsonl::RecordView("{\"url\":\"/a\",\"ts\":100}")));
+  CHECK(validator.add(jsonl::RecordView("{\"url\":\"/b\",\"ts\":100}")));
+  // Missing field: schema failure (and no orderable timestamp).
+  CHECK(!validator.add(jsonl::RecordView("{\"url\":\"/c\"}")));
+  // Regressing timestamp.
+  CHECK(!validator.add(jsonl::RecordView("{\"url\":\"/d\",\"ts\":50}")));
+  CHECK_EQ(validator.records(), 4u);
+  CHECK_EQ(validator.schema_errors(), 1u);
+  CHECK_EQ(validator.timestamp_regressions(), 2u);
+  CHECK_EQ(validator.utf8_errors(), 0u);
+  CHECK(!validator.ok());
+
+  std::string report = validator.report();
+  CHECK(report.find("test name=validate.utf8 status=ok") !=
+        std::string::npos);
+  CHECK(report.find("test name=validate.schema status=fail errors=1") !=
+        std::string::npos);
+  CHECK(report.find("test name=validate.timestamps status=fail errors=2") !=
+        std::string::npos);
+  CHECK(report.find("summary tests=3 failed=2") != std::string::npos);
+}
+
+TEST(validator_file_pass_keeps_line_rate_counters) {
+  const char* path = "validate_test.jsonl";
+  std::FILE* f = std::fopen(path, "w");
+  for (int i = 0; i < 8000; ++i) {
+    std::fprintf(f, "{\"url\":\"/e/%d\",\"ts\":%d}\n", i % 5, i);
+  }
+  std::fclose(f);
+
+  jsonl::Validator::Options options;
+  options.timestamp_field = "ts";
+  jsonl::Validator validator(options);
+  CHECK(validator.validate_file(path));
+  CHECK_EQ(validator.records(), 8000u);
+  CHECK(validator.ok());
+
+  const char* report_path = "validate_report.txt";
+  CHECK(validator.write_report(report_path));
+  std::FILE* r = std::fopen(report_path, "r");
+  CHECK(r != nullptr);
+  char buf[256];
+  std::string contents;
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), r)) > 0) contents.append(buf, n);
+  std::fclose(r);
+  CHECK(contents.find("summary tests=2 failed=0") != std::string::npos);
+  std::remove(path);
+  std::remove(report_path);
+}
+
+TEST(validator_file_attributes_bad_bytes_to_records) {
+  const char* path = "validate_bad.jsonl";
+  std::FILE* f = std::fopen(path, "w");
+  std::fprintf(f, "{\"k\":\"fine\"}\n");
+  std::fprintf(f, "{\"k\":\"bad\xc3(\"}\n");  // truncated sequence
+  std::fprintf(f, "{\"k\":\"fine too\"}\n");
+  std::fclose(f);
+
+  jsonl::Validator validator({});
+  CHECK(validator.validate_file(path));
+  CHECK_EQ(validator.records(), 3u);
+  CHECK_EQ(validator.utf8_errors(), 1u);
+  std::remove(path);
+}